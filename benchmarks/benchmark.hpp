@@ -0,0 +1,48 @@
+/**
+ * @file benchmark.hpp
+ * @brief This file contains the timing helpers shared by the benchmarks.
+ */
+
+#ifndef PROJECT_BENCHMARK_HPP
+    #define PROJECT_BENCHMARK_HPP
+
+#include <chrono>
+#include <algorithm>
+#include <limits>
+
+  /**
+ * @brief The number of repeats of every measure, the fastest one is kept
+ */
+constexpr int BENCHMARK_REPEATS = 5;
+
+  /**
+ * @brief A sink for the results of the timed calls, so the compiler cannot remove them
+ */
+inline volatile double benchmark_sink = 0.0;
+
+  /**
+ * @brief Time a function.
+ * @details The function is called iterations times in a row, and the mean time per call is
+ * measured BENCHMARK_REPEATS times; the fastest of them is the one least disturbed by the
+ * rest of the system.
+ * @tparam Function The type of the function, called without arguments.
+ * @param function The function to time.
+ * @param iterations The number of calls of every repeat.
+ * @return The time per call in microseconds.
+ */
+template <typename Function>
+double minimumMicroseconds(Function function, size_t iterations)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t k = 0; k < iterations; ++k)
+            function();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count() / static_cast<double>(iterations));
+    }
+    return best;
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../include/optionpricing/finance_matrix.hpp"
+#include "../include/optionpricing/finance_montecarloutils.hpp"
+
+using NestedMatrix = std::vector<std::vector<double>>;
+
+  // Reference Cholesky factorization on nested vectors, one row pointer per entry
+static NestedMatrix nestedCholesky(const NestedMatrix &A)
+{
+    size_t n = A.size();
+    NestedMatrix L(n, std::vector<double>(n, 0.0));
+    for (size_t c = 0; c < n; ++c)
+    {
+        double sum = 0.0;
+        for (size_t k = 0; k < c; ++k)
+            sum += L[c][k] * L[c][k];
+        L[c][c] = std::sqrt(A[c][c] - sum);
+        for (size_t i = c + 1; i < n; ++i)
+        {
+            sum = 0.0;
+            for (size_t k = 0; k < c; ++k)
+                sum += L[i][k] * L[c][k];
+            L[i][c] = (A[i][c] - sum) / L[c][c];
+        }
+    }
+    return L;
+}
+
+  // Reference products and solves on nested vectors, L^T \ b reads the columns of L
+static void nestedProduct(const NestedMatrix &A, const double *x, double *y)
+{
+    for (size_t i = 0; i < A.size(); ++i)
+    {
+        double sum = 0.0;
+        for (size_t k = 0; k < A[i].size(); ++k)
+            sum += A[i][k] * x[k];
+        y[i] = sum;
+    }
+}
+
+static void nestedLowerProduct(const NestedMatrix &L, const double *x, double *y)
+{
+    for (size_t i = 0; i < L.size(); ++i)
+    {
+        double sum = 0.0;
+        for (size_t k = 0; k <= i; ++k)
+            sum += L[i][k] * x[k];
+        y[i] = sum;
+    }
+}
+
+static void nestedLowerSolve(const NestedMatrix &L, const double *b, double *x)
+{
+    for (size_t i = 0; i < L.size(); ++i)
+    {
+        double sum = b[i];
+        for (size_t k = 0; k < i; ++k)
+            sum -= L[i][k] * x[k];
+        x[i] = sum / L[i][i];
+    }
+}
+
+static void nestedLowerTransposeSolve(const NestedMatrix &L, const double *b, double *x)
+{
+    size_t n = L.size();
+    for (size_t i = n; i-- > 0;)
+    {
+        double sum = b[i];
+        for (size_t k = i + 1; k < n; ++k)
+            sum -= L[k][i] * x[k];
+        x[i] = sum / L[i][i];
+    }
+}
+
+  // Benchmark of the Cholesky factorization and of the matrix-vector kernels of finance_matrix,
+  // against the same loops on nested vectors, on the sample covariance of N + 20 normal vectors
+int main()
+{
+    std::printf("Times in microseconds, nested vectors -> Matrix\n");
+    std::printf("%6s %22s %22s %22s %22s %22s %12s\n", "N", "Cholesky", "L x", "L \\ b", "L^T \\ b", "C x", "max |diff|");
+
+    for (size_t n : {size_t(4), size_t(64), size_t(512)})
+    {
+        std::mt19937_64 engine(1);
+        std::normal_distribution<double> normal;
+
+        size_t observations = n + 20;
+        std::vector<double> samples(observations * n);
+        for (double &value : samples)
+            value = normal(engine);
+
+        Matrix covariance(n, n);
+        NestedMatrix nested_covariance(n, std::vector<double>(n));
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = 0; j < n; ++j)
+            {
+                double sum = 0.0;
+                for (size_t t = 0; t < observations; ++t)
+                    sum += samples[t * n + i] * samples[t * n + j];
+                covariance(i, j)        = sum / static_cast<double>(observations);
+                nested_covariance[i][j] = covariance(i, j);
+            }
+        }
+
+          // Fewer iterations for the larger sizes, so every size takes about as long
+        size_t factorization_iterations = n == 4 ? 200000 : (n == 64 ? 200 : 2);
+        size_t product_iterations       = n == 4 ? 2000000 : (n == 64 ? 20000 : 200);
+
+        CholeskyError error;
+        double nested_cholesky = minimumMicroseconds([&] { benchmark_sink = nestedCholesky(nested_covariance)[n - 1][0]; }, factorization_iterations);
+        double cholesky        = minimumMicroseconds([&] { benchmark_sink = choleskyFactorization(covariance, error)(n - 1, 0); }, factorization_iterations);
+
+        NestedMatrix nested_L = nestedCholesky(nested_covariance);
+        Matrix L              = choleskyFactorization(covariance, error);
+        double max_difference = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (size_t j = 0; j <= i; ++j)
+                max_difference = std::max(max_difference, std::fabs(nested_L[i][j] - L(i, j)));
+        }
+
+        std::vector<double> x(n), y(n);
+        for (double &value : x)
+            value = normal(engine);
+
+        double nested_lower = minimumMicroseconds([&] { nestedLowerProduct(nested_L, x.data(), y.data()); benchmark_sink = y[n - 1]; }, product_iterations);
+        double lower        = minimumMicroseconds([&] { lowerMatrixVectorProduct(L, x.data(), y.data()); benchmark_sink = y[n - 1]; }, product_iterations);
+        double nested_solve = minimumMicroseconds([&] { nestedLowerSolve(nested_L, x.data(), y.data()); benchmark_sink = y[n - 1]; }, product_iterations);
+        double solve        = minimumMicroseconds([&] { lowerSolve(L, x.data(), y.data()); benchmark_sink = y[n - 1]; }, product_iterations);
+        double nested_back  = minimumMicroseconds([&] { nestedLowerTransposeSolve(nested_L, x.data(), y.data()); benchmark_sink = y[0]; }, product_iterations);
+        double back         = minimumMicroseconds([&] { lowerTransposeSolve(L, x.data(), y.data()); benchmark_sink = y[0]; }, product_iterations);
+        double nested_full  = minimumMicroseconds([&] { nestedProduct(nested_covariance, x.data(), y.data()); benchmark_sink = y[0]; }, product_iterations);
+        double full         = minimumMicroseconds([&] { matrixVectorProduct(covariance, x.data(), y.data()); benchmark_sink = y[0]; }, product_iterations);
+
+        std::printf("%6zu %10.3f -> %9.3f %10.3f -> %9.3f %10.3f -> %9.3f %10.3f -> %9.3f %10.3f -> %9.3f %12.1e\n",
+                    n, nested_cholesky, cholesky, nested_lower, lower, nested_solve, solve, nested_back, back, nested_full, full, max_difference);
+    }
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../include/integration/randomstream.hpp"
+#include "../include/optionpricing/finance_shocks.hpp"
+#include "../include/optionpricing/finance_montecarlo.hpp"
+#include "../include/optionpricing/optionparameters.hpp"
+
+  // Normals of every stream, the size of a tile of STEPS_PER_TILE steps of a block of paths
+constexpr size_t NORMALS_PER_STREAM = STEPS_PER_TILE * PATHS_PER_BLOCK;
+
+  // Number of paths of every pricing call
+constexpr size_t NORMALS_BENCHMARK_POINTS = 200000;
+
+  // Number of normals of the check of the moments
+constexpr size_t NORMALS_MOMENTS_COUNT = size_t(1) << 24;
+
+  // Time per normal of RandomStream::fillNormal, one new stream per tile
+template <typename T>
+static double fillNormalNanoseconds()
+{
+    std::vector<T> normals(NORMALS_PER_STREAM);
+    uint64_t stream_index = 0;
+    double microseconds = minimumMicroseconds([&]
+    {
+        RandomStream stream(7, stream_index++);
+        stream.fillNormal(normals.data(), normals.size());
+        benchmark_sink = normals[5];
+    }, 20000);
+    return microseconds * 1e3 / static_cast<double>(NORMALS_PER_STREAM);
+}
+
+  // Time per normal of std::normal_distribution on a 64-bit Mersenne Twister
+template <typename T>
+static double standardNormalNanoseconds()
+{
+    std::vector<T> normals(NORMALS_PER_STREAM);
+    std::mt19937_64 engine(7);
+    std::normal_distribution<T> distribution;
+    double microseconds = minimumMicroseconds([&]
+    {
+        for (T &value : normals)
+            value = distribution(engine);
+        benchmark_sink = normals[5];
+    }, 2000);
+    return microseconds * 1e3 / static_cast<double>(NORMALS_PER_STREAM);
+}
+
+  // Time per correlated draw of one asset of CorrelatedShocks, on a fixed 4 x 4 factor
+template <typename T>
+static double shocksNanoseconds()
+{
+    Matrix L(4, 4);
+    double factor[4][4] = {{0.02, 0.0, 0.0, 0.0}, {0.01, 0.02, 0.0, 0.0}, {0.005, 0.01, 0.02, 0.0}, {0.001, 0.002, 0.003, 0.02}};
+    for (size_t i = 0; i < 4; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+            L(i, j) = factor[i][j];
+    }
+
+    CorrelatedShocks<T> shocks(L, 1.0 / 252.0);
+    std::vector<T> normals, increments;
+    uint64_t stream_index = 0;
+    double microseconds = minimumMicroseconds([&]
+    {
+        RandomStream stream(7, stream_index++);
+        shocks.generate(stream, STEPS_PER_TILE, PATHS_PER_BLOCK, normals, increments);
+        benchmark_sink = increments[5];
+    }, 5000);
+    return microseconds * 1e3 / static_cast<double>(4 * NORMALS_PER_STREAM);
+}
+
+  // Variance and kurtosis of the normals of one stream, with the largest absolute value
+template <typename T>
+static void printMoments(const char *name, uint64_t seed)
+{
+    std::vector<T> normals(NORMALS_MOMENTS_COUNT);
+    RandomStream stream(seed, 0);
+    stream.fillNormal(normals.data(), normals.size());
+
+    double mean = 0.0;
+    for (T value : normals)
+        mean += static_cast<double>(value);
+    mean /= static_cast<double>(normals.size());
+
+    double m2 = 0.0, m4 = 0.0, largest = 0.0;
+    for (T value : normals)
+    {
+        double deviation = static_cast<double>(value) - mean;
+        m2     += deviation * deviation;
+        m4     += deviation * deviation * deviation * deviation;
+        largest = std::max(largest, std::fabs(static_cast<double>(value)));
+    }
+    m2 /= static_cast<double>(normals.size());
+    m4 /= static_cast<double>(normals.size());
+    std::printf("%-8s seed %-4llu %12.5f %12.4f %12.3f\n", name, static_cast<unsigned long long>(seed), m2, m4 / (m2 * m2), largest);
+}
+
+  // Paths per second of the Asian call on the basket of the assets
+static double asianPathsPerSecond(const std::vector<Asset> &assets, PathPrecision precision)
+{
+    std::vector<const Asset *> assetPtrs;
+    for (const Asset &asset : assets)
+        assetPtrs.push_back(&asset);
+    double strike_price = calculateStrikePrice(assets);
+
+    CovarianceError cov_error;
+    Matrix covariance_matrix = calculateCovarianceMatrix(assetPtrs, cov_error);
+    CholeskyError cholesky_error;
+    Matrix cholesky_factor = factorizeCovarianceMatrix(covariance_matrix, assets.size(), cholesky_error);
+
+    std::vector<double> predicted_assets_prices(assets.size());
+    std::vector<double> importance_shift;
+    double variance_ratio;
+    MonteCarloError error;
+    double microseconds = minimumMicroseconds([&]
+    {
+        RunningStatistics statistics;
+        monteCarloPricePrediction(NORMALS_BENCHMARK_POINTS, assetPtrs, cholesky_factor, statistics, strike_price, predicted_assets_prices,
+                                  OptionType::Asian, precision, PathConstruction::PseudoRandom,
+                                  VarianceReduction::None, importance_shift, variance_ratio, nullptr, 7, error);
+        benchmark_sink = statistics.getMean();
+    }, 1);
+    return static_cast<double>(NORMALS_BENCHMARK_POINTS) / microseconds * 1e6;
+}
+
+  // Benchmark of the normal generators in double and single precision, of the correlated
+  // shocks and of the Asian paths built on them. The directory of the data can be given as
+  // the first argument, ../data/ from the build directory by default
+int main(int argc, char **argv)
+{
+    std::string directory = argc > 1 ? argv[1] : "../data/";
+
+    std::printf("Nanoseconds per normal, %zu normals per stream\n", NORMALS_PER_STREAM);
+    std::printf("%-40s %10s %10s\n", "", "double", "float");
+    std::printf("%-40s %10.2f %10.2f\n", "RandomStream::fillNormal", fillNormalNanoseconds<double>(), fillNormalNanoseconds<float>());
+    std::printf("%-40s %10.2f %10.2f\n", "std::normal_distribution (mt19937_64)", standardNormalNanoseconds<double>(), standardNormalNanoseconds<float>());
+    std::printf("%-40s %10.2f %10.2f\n", "CorrelatedShocks, 4 assets, per draw", shocksNanoseconds<double>(), shocksNanoseconds<float>());
+
+    std::printf("\nMoments of %zu normals\n", NORMALS_MOMENTS_COUNT);
+    std::printf("%-18s %12s %12s %12s\n", "", "variance", "kurtosis", "max |z|");
+    for (uint64_t seed : {1, 2, 3, 4})
+    {
+        printMoments<double>("double", seed);
+        printMoments<float>("float", seed);
+    }
+
+    std::printf("\nAsian call paths/s, %zu paths per call\n", NORMALS_BENCHMARK_POINTS);
+    std::printf("%-40s %10s %10s\n", "", "double", "float");
+    for (AssetCountType asset_count_type : {AssetCountType::Single, AssetCountType::Multiple})
+    {
+        std::vector<Asset> assets;
+        if (loadAssets(directory, assets, asset_count_type) != LoadAssetError::Success)
+        {
+            std::cerr << "Error loading the assets of " << directory << std::endl;
+            return 1;
+        }
+        std::string label = std::to_string(assets.size()) + (assets.size() == 1 ? " asset" : " assets");
+        std::printf("%-40s %10.3e %10.3e\n", label.c_str(), asianPathsPerSecond(assets, PathPrecision::Double), asianPathsPerSecond(assets, PathPrecision::Single));
+    }
+
+    return 0;
+}
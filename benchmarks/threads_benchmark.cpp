@@ -0,0 +1,73 @@
+#include <omp.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../include/optionpricing/finance_montecarlo.hpp"
+#include "../include/optionpricing/optionparameters.hpp"
+
+  // Number of paths of every call and largest number of threads of the sweep
+constexpr size_t THREADS_BENCHMARK_POINTS = 500000;
+constexpr int THREADS_BENCHMARK_MAX       = 8;
+
+  // Benchmark of the thread scaling of monteCarloPricePrediction: Asian call on the basket of
+  // the assets of data/, from 1 to THREADS_BENCHMARK_MAX threads. The directory of the data
+  // can be given as the first argument, ../data/ from the build directory by default
+int main(int argc, char **argv)
+{
+    std::string directory = argc > 1 ? argv[1] : "../data/";
+
+    std::vector<Asset> assets;
+    if (loadAssets(directory, assets, AssetCountType::Multiple) != LoadAssetError::Success)
+    {
+        std::cerr << "Error loading the assets of " << directory << std::endl;
+        return 1;
+    }
+    std::vector<const Asset *> assetPtrs;
+    for (const Asset &asset : assets)
+        assetPtrs.push_back(&asset);
+    double strike_price = calculateStrikePrice(assets);
+
+    CovarianceError cov_error;
+    Matrix covariance_matrix = calculateCovarianceMatrix(assetPtrs, cov_error);
+    if (cov_error != CovarianceError::Success)
+    {
+        std::cerr << "Error calculating the covariance matrix" << std::endl;
+        return 1;
+    }
+    CholeskyError cholesky_error;
+    Matrix cholesky_factor = factorizeCovarianceMatrix(covariance_matrix, assets.size(), cholesky_error);
+    if (cholesky_error == CholeskyError::Failure)
+        return 1;
+
+    std::printf("Asian call, %zu assets, %zu paths per call\n", assets.size(), THREADS_BENCHMARK_POINTS);
+    std::printf("%8s %14s %12s\n", "threads", "paths/s", "price");
+
+    for (int threads = 1; threads <= THREADS_BENCHMARK_MAX; ++threads)
+    {
+        omp_set_num_threads(threads);
+
+        RunningStatistics statistics;
+        std::vector<double> predicted_assets_prices(assets.size());
+        std::vector<double> importance_shift;
+        double variance_ratio;
+        MonteCarloError error;
+        double microseconds = minimumMicroseconds([&]
+        {
+            statistics = RunningStatistics();
+            monteCarloPricePrediction(THREADS_BENCHMARK_POINTS, assetPtrs, cholesky_factor, statistics, strike_price, predicted_assets_prices,
+                                      OptionType::Asian, PathPrecision::Double, PathConstruction::PseudoRandom,
+                                      VarianceReduction::None, importance_shift, variance_ratio, nullptr, 7, error);
+        }, 1);
+        if (error != MonteCarloError::Success)
+        {
+            std::cerr << "Error pricing the option" << std::endl;
+            return 1;
+        }
+
+        std::printf("%8d %14.3e %12.6f\n", threads, static_cast<double>(THREADS_BENCHMARK_POINTS) / microseconds * 1e6, statistics.getMean());
+    }
+
+    return 0;
+}
@@ -12,6 +12,11 @@
 #include <vector>
 #include <functional>
 #include <string>
+#include <cstdint>
+
+#include "integration/qmcsequence.hpp"
+#include "integration/runningstatistics.hpp"
+#include "integration/geometry/hypersphere.hpp"
 
   /**
  * @brief Read an input from the user
@@ -65,14 +70,24 @@ void readValidatedInput(const std::string &prompt, T &value, std::function<bool(
   /**
  * @brief Calculate the approximated value of the integral over a chosen domain
  * @details This function reads the input from the user and builds the integral over a chosen domain using the Monte Carlo method.
- * @param n A reference to the number of points to generate
+ * @param n A reference to the number of points to generate, the maximum with a tolerance
  * @param dim A reference to the dimension of the domain
  * @param rad A reference to the radius of the hypersphere
  * @param edge A reference to the edge of the hypercube
  * @param function A reference to the function to integrate
  * @param domain_type A reference to the domain type
  * @param hyper_rectangle_bounds A reference to the bounds of the hyperrectangle
+ * @param block_size A reference to the number of points evaluated together in bulk mode
+ * @param seed A reference to the seed of the random number generator
+ * @param mode A reference to the sampling mode
+ * @param replicates A reference to the number of randomized replicates of the quasi-Monte Carlo modes
+ * @param sphere_sampler A reference to the algorithm drawing the points of the hypersphere
+ * @param rule A reference to the stopping rule
+ * @param tolerance A reference to the absolute or relative tolerance of the 95% confidence interval half-width
+ * @param single_precision A reference to the flag drawing the random blocks as float32 numbers
     */
-void buildIntegral(size_t &n, size_t &dim, double &rad, double &edge, std::string &function, std::string &domain_type, std::vector<double> &hyper_rectangle_bounds);
+void buildIntegral(size_t &n, size_t &dim, double &rad, double &edge, std::string &function, std::string &domain_type, std::vector<double> &hyper_rectangle_bounds, size_t &block_size, uint64_t &seed,
+                   SamplingMode &mode, size_t &replicates, SphereSampler &sphere_sampler, StoppingRule &rule, double &tolerance,
+                   bool &single_precision);
 
 #endif
@@ -0,0 +1,98 @@
+/**
+ * @file compiledexpression.hpp
+ * @brief This file contains the declaration of the CompiledExpression class.
+ */
+
+#ifndef PROJECT_COMPILEDEXPRESSION_
+    #define PROJECT_COMPILEDEXPRESSION_
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+#include "../../external/muparser-2.3.4/include/muParser.h"
+#include "vectormath.hpp"
+
+/**
+ * @class CompiledExpression
+ * @brief Specialized evaluator lowered from the muParser bytecode.
+ *
+ * The RPN bytecode of a parsed expression is translated once into a
+ * straight-line program working on whole blocks of points: every instruction
+ * runs a SIMD loop over the block instead of dispatching the interpreter for
+ * every point. Constants are folded during the translation, the ternary
+ * operator becomes a select, and exp, log, sin and cos use the vectorized
+ * kernels of vectormath.hpp. If the bytecode contains anything that cannot be
+ * lowered (string functions, bulk callbacks, assignments, user defined
+ * multi-argument functions) isLowered() returns false and the caller must
+ * keep using muParser.
+ */
+class CompiledExpression
+{
+public:
+    /**
+     * @brief Lower the bytecode of a parser into a block program
+     * @param parser The parser, with its expression already parsed
+     * @param block The structure-of-arrays block the variables x1..xd are bound to
+     * @param dim The number of variables
+     * @param block_size The maximum number of points in a block
+     */
+    CompiledExpression(const mu::Parser &parser, const std::vector<double> &block, size_t dim, size_t block_size);
+
+    /**
+     * @brief Check whether the expression has been lowered
+     * @return True if evaluate() can be used, false if muParser must be used instead
+     */
+    inline bool isLowered() const { return lowered; }
+
+    /**
+     * @brief Evaluate the program on the first count points of the block
+     * @param results Vector to store the values of the function, at least count long
+     * @param count The number of points to evaluate
+     */
+    void evaluate(std::vector<double> &results, size_t count);
+
+private:
+    enum class OpCode
+    {
+        Fill, Copy, Add, Sub, Mul, Div, Pow, Min, Max,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, And, Or,
+        Square, Cube, Fourth, MulAdd, Negate, Abs, Sqrt, Exp, Log, Sin, Cos,
+        Call0, Call1, Call2, Call3, Select
+    };
+
+    /**
+     * @brief A value of the program: a constant, a column of the block or a register
+     */
+    struct Operand
+    {
+        enum class Kind { Constant, Column, Register } kind;
+        double value;
+        size_t index;
+    };
+
+    struct Instruction
+    {
+        OpCode op;
+        size_t out;
+        Operand args[3];
+        mu::generic_callable_type fun;
+    };
+
+    bool lower(const mu::ParserByteCode &bytecode);
+    const double *address(const Operand &operand) const;
+    Operand emit(OpCode op, size_t out, const Operand &a, const Operand &b = constant(0.0), const Operand &c = constant(0.0));
+    Operand materialize(const Operand &operand, size_t out);
+    static Operand constant(double value) { return {Operand::Kind::Constant, value, 0}; }
+
+    const std::vector<double> &block;
+    size_t dim;
+    size_t block_size;
+    size_t num_registers;
+    std::vector<Instruction> program;
+    std::vector<double> registers;
+    Operand result;
+    bool lowered;
+};
+
+#endif
@@ -9,8 +9,12 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <memory>
 
 #include "../../external/muparser-2.3.4/include/muParser.h"
+#include "compiledexpression.hpp"
 
   /**
  * @brief This function is used to evaluate a function
@@ -22,4 +26,118 @@
  */
 double evaluateFunction(const std::string &expression, const std::vector<double> &point, mu::Parser &parser);
 
-#endif
\ No newline at end of file
+/**
+ * @class FunctionEvaluator
+ * @brief Compiled integrand bound to a reusable point buffer.
+ *
+ * The expression is parsed once at construction and the variables x1..xd
+ * are bound to the elements of an internal point buffer. The caller writes
+ * the coordinates of a sample into the buffer returned by getPoint() and
+ * calls evaluate(), which runs the muParser bytecode without any string
+ * handling or allocation. Every thread must own its own instance.
+ */
+class FunctionEvaluator
+{
+public:
+    /**
+     * @brief Construct a new FunctionEvaluator object
+     * @param expression The expression of the function
+     * @param dim The number of variables of the function
+     */
+    FunctionEvaluator(const std::string &expression, size_t dim);
+
+    /**
+     * @brief The parser holds the addresses of the point buffer, so copies are forbidden
+     */
+    FunctionEvaluator(const FunctionEvaluator &) = delete;
+    FunctionEvaluator &operator=(const FunctionEvaluator &) = delete;
+
+    /**
+     * @brief Get the point buffer bound to the variables of the function
+     * @return A reference to the point buffer
+     */
+    inline std::vector<double> &getPoint() { return point; }
+
+    /**
+     * @brief Evaluate the function at the point currently stored in the buffer
+     * @return The value of the function
+     */
+    inline double evaluate()
+    {
+        try
+        {
+            return parser.Eval();
+        }
+        catch (mu::Parser::exception_type &e)
+        {
+            std::cout << "Error evaluating expression: " << e.GetMsg() << std::endl;
+            return 0.0;
+        }
+    }
+
+private:
+    std::vector<double> point;
+    mu::Parser parser;
+};
+
+/**
+ * @class BulkFunctionEvaluator
+ * @brief Compiled integrand evaluated over blocks of points.
+ *
+ * The points of a block are stored in structure-of-arrays layout: the
+ * coordinate j of the k-th point lives at block[j * block_size + k], so every
+ * variable xj is bound to one contiguous array. After parsing, the bytecode
+ * is lowered into a CompiledExpression that evaluates a whole block with
+ * SIMD loops; expressions that cannot be lowered fall back to a single call
+ * to the muParser bulk interface. Every thread must own its own instance.
+ */
+class BulkFunctionEvaluator
+{
+public:
+    /**
+     * @brief Construct a new BulkFunctionEvaluator object
+     * @param expression The expression of the function
+     * @param dim The number of variables of the function
+     * @param block_size The maximum number of points in a block
+     */
+    BulkFunctionEvaluator(const std::string &expression, size_t dim, size_t block_size);
+
+    /**
+     * @brief The parser holds the addresses of the block buffer, so copies are forbidden
+     */
+    BulkFunctionEvaluator(const BulkFunctionEvaluator &) = delete;
+    BulkFunctionEvaluator &operator=(const BulkFunctionEvaluator &) = delete;
+
+    /**
+     * @brief Get the block buffer bound to the variables of the function
+     * @return A reference to the block buffer, in structure-of-arrays layout
+     */
+    inline std::vector<double> &getBlock() { return block; }
+
+    /**
+     * @brief Get the block size
+     * @return The maximum number of points in a block
+     */
+    inline size_t getBlockSize() const { return block_size; }
+
+    /**
+     * @brief Check whether the compiled evaluator is used
+     * @return True if the expression has been lowered, false if muParser evaluates it
+     */
+    inline bool isCompiled() const { return compiled && compiled->isLowered(); }
+
+    /**
+     * @brief Evaluate the function at the first count points of the block
+     * @param results Vector to store the values of the function, at least count long
+     * @param count The number of points to evaluate
+     */
+    void evaluate(std::vector<double> &results, size_t count);
+
+private:
+    size_t block_size;
+    std::vector<double> block;
+    mu::Parser parser;
+    std::unique_ptr<CompiledExpression> compiled;
+};
+
+#endif
@@ -10,6 +10,7 @@
 #include <string>
 #include <iostream>
 
+#include "../randomstream.hpp"
 #include "../../optionpricing/asset.hpp"
 
 /**
@@ -26,10 +27,41 @@ public:
     /**
      * @brief Generate a random point inside the geometry
      * @details Generates a random point inside the geometry domain
-     * in a parallel fashion using OpenMP following a uniform distribution.
+     * following a uniform distribution.
      * @param random_point Vector to store the random point coordinates
+     * @param stream The random stream of the calling thread
      */
-    virtual void generateRandomPoint(std::vector<double> &random_point) = 0;
+    virtual void generateRandomPoint(std::vector<double> &random_point, RandomStream &stream) = 0;
+
+    /**
+     * @brief Generate a block of random points inside the geometry
+     * @details Generates count random points following a uniform distribution
+     * and stores them in structure-of-arrays layout: the coordinate j of the
+     * k-th point is stored in random_block[j * block_size + k].
+     * @param random_block Vector to store the coordinates, at least dimension * block_size long
+     * @param block_size The stride between two coordinates of the same point
+     * @param count The number of points to generate, at most block_size
+     * @param stream The random stream of the calling thread
+     * @param scratch Scratch buffer of the calling thread, reused by its next blocks; the
+     * geometry resizes it if it needs one
+     */
+    virtual void generateRandomBlock(std::vector<double> &random_block, size_t block_size, size_t count, RandomStream &stream, std::vector<double> &scratch) = 0;
+
+    /**
+     * @brief Check whether the geometry can be sampled with quasi-random points
+     * @return True if mapFromUnitCube is implemented
+     */
+    virtual inline bool supportsUnitCubeMapping() { return false; }
+
+    /**
+     * @brief Map a block of points of the unit cube into the geometry
+     * @details The map must be affine so that low-discrepancy points stay
+     * evenly spread. The block is in structure-of-arrays layout.
+     * @param random_block Vector with the coordinates in [0, 1), overwritten with the mapped ones
+     * @param block_size The stride between two coordinates of the same point
+     * @param count The number of points to map
+     */
+    virtual void mapFromUnitCube(std::vector<double> &random_block, size_t block_size, size_t count) {}
 
     /**
      * @brief Calculate the volume of the geometry
@@ -6,7 +6,6 @@
 #ifndef PROJECT_HYPERCUBE_
     #define PROJECT_HYPERCUBE_
 
-#include <random>
 #include <vector>
 #include <cmath>
 #include <omp.h>
@@ -34,10 +33,37 @@ public:
     /**
      * @brief Generate a random point inside the hypercube
      * @details Generates a random point inside the hypercube domain
-     * in a parallel fashion using OpenMP following a uniform distribution.
+     * following a uniform distribution.
      * @param random_point Vector to store the random point coordinates
+     * @param stream The random stream of the calling thread
      */
-    void generateRandomPoint(std::vector<double> &random_point) override;
+    void generateRandomPoint(std::vector<double> &random_point, RandomStream &stream) override;
+
+    /**
+     * @brief Generate a block of random points inside the hypercube
+     * @details Generates count random points inside the hypercube domain
+     * following a uniform distribution, in structure-of-arrays layout.
+     * @param random_block Vector to store the coordinates, at least dimension * block_size long
+     * @param block_size The stride between two coordinates of the same point
+     * @param count The number of points to generate, at most block_size
+     * @param stream The random stream of the calling thread
+     * @param scratch Scratch buffer of the calling thread, unused
+     */
+    void generateRandomBlock(std::vector<double> &random_block, size_t block_size, size_t count, RandomStream &stream, std::vector<double> &scratch) override;
+
+    /**
+     * @brief The hypercube can be sampled with quasi-random points
+     * @return True
+     */
+    inline bool supportsUnitCubeMapping() override { return true; }
+
+    /**
+     * @brief Map a block of points of the unit cube into the hypercube
+     * @param random_block Vector with the coordinates in [0, 1), overwritten with the mapped ones
+     * @param block_size The stride between two coordinates of the same point
+     * @param count The number of points to map
+     */
+    void mapFromUnitCube(std::vector<double> &random_block, size_t block_size, size_t count) override;
 
     /**
      * @brief Calculate the volume of the hypercube
@@ -73,8 +99,6 @@ private:
     double edge;
     size_t dimension;
     double volume;
-    std::random_device rd;
-    std::default_random_engine eng;
 };
 
 #endif
\ No newline at end of file
@@ -6,21 +6,37 @@
 #ifndef PROJECT_HYPERSPHERE_
     #define PROJECT_HYPERSPHERE_
 
-#include <random>
 #include <vector>
 #include <cmath>
+#include <atomic>
+#include <algorithm>
 #include <omp.h>
 
 #include "geometry.hpp" // Assuming this includes necessary headers
 #include "../functionevaluator.hpp"
+#include "../vectormath.hpp"
 
 constexpr double PI = 3.14159265358979323846;
 
+/**
+ * @brief The algorithm used to draw uniform points in the hypersphere
+ */
+enum class SphereSampler
+{
+    Direct,    /**< Gaussian direction times radius * U^(1/d), d + 1 uniforms per point (rounded up to even d) */
+    Rejection  /**< Uniform points of the bounding hypercube, rejected outside the sphere */
+};
+
 /**
  * @class HyperSphere
  * @brief Represents a hypersphere, a geometric shape in a space with a large number of dimensions.
  *
  * A hypersphere is a generalization of a sphere to an arbitrary number of dimensions.
+ * The default sampler normalizes a vector of independent normal variables, which
+ * is uniformly distributed on the surface, and scales it by radius * U^(1/d),
+ * which has the radial density of a uniform point of the ball. Unlike the
+ * rejection sampler its cost grows linearly with the dimension: the acceptance
+ * rate of the bounding cube is already about 0.25% at d = 10.
  */
 class HyperSphere: public Geometry
 {
@@ -29,16 +45,33 @@ public:
      * @brief Construct a new HyperSphere object
      * @param dim The dimension of the hypersphere
      * @param rad The radius of the hypersphere
+     * @param sampler The algorithm used to draw the points
      */
-    explicit HyperSphere(size_t dim, double rad);
+    explicit HyperSphere(size_t dim, double rad, SphereSampler sampler = SphereSampler::Direct);
 
     /**
      * @brief Generate a random point inside the hypersphere
      * @details Generates a random point inside the hypersphere domain
-     * in a parallel fashion using OpenMP following a uniform distribution.
+     * following a uniform distribution.
      * @param random_point Vector to store the random point coordinates
+     * @param stream The random stream of the calling thread
      */
-    void generateRandomPoint(std::vector<double> &random_point) override;
+    void generateRandomPoint(std::vector<double> &random_point, RandomStream &stream) override;
+
+    /**
+     * @brief Generate a block of random points inside the hypersphere
+     * @details Generates count random points inside the hypersphere domain
+     * following a uniform distribution, in structure-of-arrays layout. The
+     * direct sampler fills whole columns with the SIMD normal generator of
+     * the stream and applies the radial scaling in SIMD loops.
+     * @param random_block Vector to store the coordinates, at least dimension * block_size long
+     * @param block_size The stride between two coordinates of the same point
+     * @param count The number of points to generate, at most block_size
+     * @param stream The random stream of the calling thread
+     * @param scratch Scratch buffer of the calling thread, grown to 2 * count values for the
+     * direct sampler and to the dimension for the rejection sampler
+     */
+    void generateRandomBlock(std::vector<double> &random_block, size_t block_size, size_t count, RandomStream &stream, std::vector<double> &scratch) override;
 
     /**
      * @brief Calculate the volume of the hypersphere
@@ -70,13 +103,33 @@ public:
         return dimension;
     }
 
+    /**
+     * @brief Get the average number of uniforms consumed per accepted point
+     * @return The ratio between the uniforms drawn and the points generated so far
+     */
+    inline double getUniformsPerPoint() const
+    {
+        uint64_t points = points_generated.load();
+        return points ? static_cast<double>(uniforms_drawn.load()) / static_cast<double>(points) : 0.0;
+    }
+
+    /**
+     * @brief Get the sampler of the hypersphere
+     * @return The algorithm used to draw the points
+     */
+    inline SphereSampler getSampler() const { return sampler; }
+
 private: 
+    void samplePoint(std::vector<double> &random_point, RandomStream &stream);
+    void generateDirectBlock(std::vector<double> &random_block, size_t block_size, size_t count, RandomStream &stream, std::vector<double> &scratch);
+
     double radius;           
     double parameter;        /**< Parameter used in volume calculation */
     double volume;           
     size_t dimension;        
-    std::random_device rd;  
-    std::default_random_engine eng; 
+    SphereSampler sampler;
+    std::atomic<uint64_t> uniforms_drawn;    /**< Uniforms consumed by all the threads */
+    std::atomic<uint64_t> points_generated;  /**< Points returned to all the threads */
 };
 
 #endif
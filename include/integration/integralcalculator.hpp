@@ -27,9 +27,11 @@
  * @param edge The edge length (for hypercube).
  * @param hyper_rectangle_bounds The bounds of the hyperrectangle.
  * @param domain_type The type of the domain.
+ * @param sphere_sampler The algorithm drawing the points of the hypersphere.
  * @return A pointer to the created geometry object.
  */
-Geometry *geometryFactory(size_t dim, double rad, double edge, std::vector<double> &hyper_rectangle_bounds, std::string domain_type);
+Geometry *geometryFactory(size_t dim, double rad, double edge, std::vector<double> &hyper_rectangle_bounds, std::string domain_type,
+                          SphereSampler sphere_sampler = SphereSampler::Direct);
 
 /**
  * @brief Core function for integral calculation using the Monte Carlo method.
@@ -9,37 +9,204 @@
 #include <omp.h>
 #include <iostream>
 #include <chrono>
+#include <algorithm>
+#include <memory>
 #include "geometry/hypercube.hpp"
 #include "geometry/hyperrectangle.hpp"
 #include "geometry/hypersphere.hpp"
+#include "randomstream.hpp"
+#include "qmcsequence.hpp"
+#include "runningstatistics.hpp"
 #include "../optionpricing/asset.hpp" 
 
+/**
+ * @brief Number of points sharing a random stream when the function is evaluated point by point
+ */
+constexpr size_t POINTS_PER_CHUNK = 1024;
+
+/**
+ * @brief Number of points of the first round of the adaptive integration
+ */
+constexpr size_t FIRST_ROUND_POINTS = 65536;
+
+/**
+ * @brief Evaluate the function on a range of chunks of points in parallel
+ * @details Every chunk is filled by generate_chunk, evaluated with a thread-local
+ * evaluator (in bulk if block_size > 1, point by point otherwise), and its
+ * statistics are stored in chunk_statistics[c - first_chunk], so the caller can
+ * merge them in a fixed order.
+ * @tparam DomainType The type of domain object
+ * @tparam ChunkGenerator Callable size_t(size_t chunk, std::vector<double> &block, size_t stride,
+ * std::vector<double> &scratch) writing the points of a chunk in structure-of-arrays layout and
+ * returning their number, scratch being the sampling scratch buffer of the thread
+ * @param function The function to integrate
+ * @param domain The domain object representing the integration domain
+ * @param block_size The number of points evaluated together with one bulk call
+ * @param chunk_size The maximum number of points of a chunk
+ * @param first_chunk The index of the first chunk to evaluate
+ * @param last_chunk One past the index of the last chunk to evaluate
+ * @param generate_chunk The generator of the points of a chunk
+ * @param chunk_statistics The statistics of the chunks, at least last_chunk - first_chunk long
+ */
+template <typename DomainType, typename ChunkGenerator>
+void evaluateChunks(const std::string &function,
+                    DomainType &domain,
+                    size_t block_size,
+                    size_t chunk_size,
+                    size_t first_chunk,
+                    size_t last_chunk,
+                    ChunkGenerator generate_chunk,
+                    std::vector<RunningStatistics> &chunk_statistics)
+{
+    size_t dim = domain.getDimension();
+
+#pragma omp parallel
+    {
+        if (block_size > 1)
+        {
+            // Thread-local integrand bound to a structure-of-arrays block of points
+            BulkFunctionEvaluator evaluator(function, dim, block_size);
+            std::vector<double> &local_random_block = evaluator.getBlock();
+            std::vector<double> local_results(block_size);
+            std::vector<double> local_scratch;
+
+#pragma omp for schedule(dynamic)
+            // Loop for generating blocks of points and evaluating the function on each block
+            for (size_t c = first_chunk; c < last_chunk; ++c)
+            {
+                size_t count = generate_chunk(c, local_random_block, block_size, local_scratch);
+
+                RunningStatistics statistics;
+                if (count > 0)
+                {
+                    evaluator.evaluate(local_results, count);
+                    statistics.addBlock(local_results.data(), count);
+                }
+                chunk_statistics[c - first_chunk] = statistics;
+            }
+        }
+        else
+        {
+            // Thread-local integrand, parsed once and bound to its own point buffer
+            FunctionEvaluator evaluator(function, dim);
+            std::vector<double> &local_random_point_vector = evaluator.getPoint();
+            std::vector<double> local_random_block(dim * chunk_size);
+            std::vector<double> local_scratch;
+
+#pragma omp for schedule(dynamic)
+            // Loop over the chunks, generating points and evaluating the function point by point
+            for (size_t c = first_chunk; c < last_chunk; ++c)
+            {
+                size_t count = generate_chunk(c, local_random_block, chunk_size, local_scratch);
+
+                RunningStatistics statistics;
+                for (size_t k = 0; k < count; ++k)
+                {
+                    for (size_t j = 0; j < dim; ++j)
+                        local_random_point_vector[j] = local_random_block[j * chunk_size + k];
+
+                    statistics.add(evaluator.evaluate());
+                }
+                chunk_statistics[c - first_chunk] = statistics;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Get the number of randomized replicates used by montecarloIntegration
+ * @details The pseudo-random mode uses one replicate. The quasi-Monte Carlo modes clamp the
+ * requested number to [2, n], and a Sobol replicate holds at most 2^32 points, so the number
+ * is raised to n / 2^32 (rounded up) if needed.
+ * @param mode The sampling mode
+ * @param n The number of points to sample
+ * @param replicates The requested number of replicates
+ * @return The number of replicates actually used
+ */
+inline size_t qmcReplicates(SamplingMode mode, size_t n, size_t replicates)
+{
+    if (mode == SamplingMode::PseudoRandom)
+        return 1;
+
+    replicates = std::max<size_t>(2, std::min(replicates, n));
+    if (mode == SamplingMode::Sobol && (n + replicates - 1) / replicates > SobolSequence::MAX_POINTS)
+        replicates = (n + SobolSequence::MAX_POINTS - 1) / SobolSequence::MAX_POINTS;
+    return replicates;
+}
+
 /**
  * @brief Compute the integral using the Monte Carlo method for a generic domain.
  * @details This function computes the integral using the Monte Carlo method for a generic domain.
  * The function integrates the provided function over the specified domain using a Monte Carlo approach.
+ * The points are split in chunks (one block, or POINTS_PER_CHUNK points when evaluating point by point),
+ * every chunk draws from its own RandomStream and the statistics of the chunks are merged in order,
+ * so the result is bit-identical for a given seed and block size whatever the number of threads.
+ *
+ * In the quasi-Monte Carlo modes the n points are split among independent randomizations
+ * (replicates) of a Sobol or Halton sequence, mapped from the unit cube into the domain; the
+ * first n % replicates replicates take one point more, so all the n points are used. A Sobol
+ * replicate holds at most 2^32 points, so the number of replicates is raised to n / 2^32 if needed.
+ * Every chunk skips ahead to its first index in the sequence, the integral is the mean of the
+ * replicate estimates and its error comes from their spread. QMC is only available for domains
+ * with an affine map from the unit cube (hc and hr), otherwise pseudo-random sampling is used.
  * @tparam DomainType The type of domain object (e.g., HyperCube, HyperRectangle, HyperSphere)
  * @param n The number of points to sample
  * @param function The function to integrate
  * @param domain The domain object representing the integration domain
- * @param variance Output parameter to store the computed variance
- * @return A pair containing the estimated integral value and the standard error
+ * @param variance Output parameter to store the computed variance; in the quasi-Monte Carlo modes
+ * it is n times the variance of the estimated mean, so sqrt(variance / n) stays its standard error
+ * @param block_size The number of points sampled and evaluated together with one bulk call,
+ * 1 evaluates the function point by point
+ * @param seed The seed of the random streams
+ * @param mode The sampling mode: pseudo-random, scrambled Sobol or randomized Halton
+ * @param replicates The number of randomized replicates of the quasi-Monte Carlo modes, at least 2
+ * @param single_precision True to draw the pseudo-random blocks as float32 numbers, the evaluation
+ * and the accumulation stay in double
+ * @return A pair containing the estimated integral value and the computation time in microseconds
  */
 template <typename DomainType>
 std::pair<double, double> montecarloIntegration(size_t n,
                                                 const std::string &function,
                                                 DomainType &domain,
-                                                double &variance)
+                                                double &variance,
+                                                size_t block_size = 1,
+                                                uint64_t seed = 0,
+                                                SamplingMode mode = SamplingMode::PseudoRandom,
+                                                size_t replicates = 16,
+                                                bool single_precision = false)
 {
-    // Initialization
-    double total_value = 0.0;
-    double total_squared_value = 0.0;
-    double result = 0.0;
-    mu::Parser parser;
+    size_t dim = domain.getDimension();
+
+    // Check that the quasi-random mode can be used on this domain
+    if (mode != SamplingMode::PseudoRandom && !domain.supportsUnitCubeMapping())
+    {
+        std::cout << "Quasi-random sampling is only available for the hc and hr domains, using pseudo-random points." << std::endl;
+        mode = SamplingMode::PseudoRandom;
+    }
+    if (mode == SamplingMode::Sobol && dim > SobolSequence::MAX_DIMENSION)
+    {
+        std::cout << "Sobol points are available up to " << SobolSequence::MAX_DIMENSION << " dimensions, using pseudo-random points." << std::endl;
+        mode = SamplingMode::PseudoRandom;
+    }
 
-    // Generate vector for storing random points
-    std::vector<double> random_point_vector;
-    random_point_vector.resize(domain.getDimension());
+    // The randomized sequences, shared read-only by the threads
+    std::vector<std::unique_ptr<QmcSequence>> sequences;
+    size_t requested_replicates = replicates;
+    replicates = qmcReplicates(mode, n, replicates);
+    if (mode == SamplingMode::Sobol && replicates > 2 && replicates > std::min(requested_replicates, n))
+        std::cout << "Sobol replicates hold at most 2^32 points, using " << replicates << " replicates." << std::endl;
+    for (size_t r = 0; r < replicates && mode != SamplingMode::PseudoRandom; ++r)
+        sequences.emplace_back(qmcSequenceFactory(mode, dim, seed, r));
+
+    // Initialization, the remainder of the points is spread over the first replicates
+    size_t points_per_replicate = n / replicates;
+    size_t extra_points = n % replicates;
+    size_t chunk_size = block_size > 1 ? block_size : POINTS_PER_CHUNK;
+    size_t chunks_per_replicate = (points_per_replicate + (extra_points > 0 ? 1 : 0) + chunk_size - 1) / chunk_size;
+    size_t num_chunks = replicates * chunks_per_replicate;
+
+    // Statistics of every chunk, merged in a fixed order after the parallel loop
+    std::vector<RunningStatistics> chunk_statistics(num_chunks);
 
     std::cout << "Computing integral..." << std::endl;
 
@@ -47,49 +214,165 @@ std::pair<double, double> montecarloIntegration(size_t n,
     auto start = std::chrono::high_resolution_clock::now();
 
     // Monte Carlo method parallelization using OpenMP
-#pragma omp parallel private(parser, result)
-    {
-        // Thread-local accumulation variables
-        double local_total_value = 0.0;
-        double local_total_squared_value = 0.0;
-        std::vector<double> local_random_point_vector(domain.getDimension());
-
-#pragma omp for reduction(+ : total_value, total_squared_value) schedule(dynamic)
-        // Loop for generating random points and evaluating the function
-        for (size_t i = 0; i < n; ++i)
-        {
-            domain.generateRandomPoint(local_random_point_vector);
-
-            result = evaluateFunction(function, local_random_point_vector, parser);
-            parser.ClearVar();
+    evaluateChunks(function, domain, block_size, chunk_size, 0, num_chunks,
+                   [&](size_t c, std::vector<double> &block, size_t stride, std::vector<double> &scratch)
+                   {
+                       size_t replicate = c / chunks_per_replicate;
+                       size_t points = points_per_replicate + (replicate < extra_points ? 1 : 0);
+                       size_t first = (c % chunks_per_replicate) * chunk_size;
+                       if (first >= points)
+                           return static_cast<size_t>(0);
+                       size_t count = std::min(chunk_size, points - first);
 
-            local_total_value += result;
-            local_total_squared_value += result * result;
-        }
+                       if (mode == SamplingMode::PseudoRandom)
+                       {
+                           RandomStream stream(seed, c, single_precision);
+                           domain.generateRandomBlock(block, stride, count, stream, scratch);
+                       }
+                       else
+                       {
+                           sequences[replicate]->generateBlock(block, stride, first, count);
+                           domain.mapFromUnitCube(block, stride, count);
+                       }
+                       return count;
+                   },
+                   chunk_statistics);
 
-        // Accumulate thread-local totals
-#pragma omp critical
-        {
-            total_value += local_total_value;
-            total_squared_value += local_total_squared_value;
-        }
+    // Merge the chunk statistics in order, replicate by replicate
+    RunningStatistics total;
+    std::vector<RunningStatistics> replicate_statistics(replicates);
+    for (size_t c = 0; c < num_chunks; ++c)
+    {
+        total.merge(chunk_statistics[c]);
+        replicate_statistics[c / chunks_per_replicate].merge(chunk_statistics[c]);
     }
 
     // Calculate the integral
     domain.calculateVolume();
     double volume = domain.getVolume();
-    double integral = total_value / static_cast<double>(n) * volume;
+    double integral = total.getMean() * volume;
 
     // Stop the timer
     auto end = std::chrono::high_resolution_clock::now();
 
     // Calculate the variance
-    variance = (total_squared_value / static_cast<double>(n)) - (total_value / static_cast<double>(n)) * (total_value / static_cast<double>(n));
+    if (mode == SamplingMode::PseudoRandom)
+    {
+        variance = total.getVariance();
+    }
+    else
+    {
+        // Spread of the independent replicate estimates around their mean
+        RunningStatistics replicate_means;
+        for (size_t r = 0; r < replicates; ++r)
+            replicate_means.add(replicate_statistics[r].getMean());
+
+        double replicate_variance = replicate_means.getVariance() * static_cast<double>(replicates) / static_cast<double>(replicates - 1);
+        variance = replicate_variance / static_cast<double>(replicates) * static_cast<double>(n);
+    }
+
+    // Compute time taken
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    // Return the estimated integral value and the computation time
+    return std::make_pair(integral, static_cast<double>(duration.count()));
+}
+
+/**
+ * @brief Compute the integral to a target precision using the Monte Carlo method.
+ * @details The points are sampled in parallel rounds of whole chunks. After every round the
+ * statistics of the new chunks are merged in order into the running statistics, and the
+ * sampling stops as soon as the half-width of the 95% confidence interval of the integral
+ * meets the absolute or relative tolerance, or when max_points points have been used.
+ * The size of the next round is predicted from the current standard error, and the chunk
+ * statistics are only stored for the current round. The chunks use the same streams as
+ * montecarloIntegration, so the result only depends on the seed, the block size and the
+ * tolerance.
+ * @tparam DomainType The type of domain object (e.g., HyperCube, HyperRectangle, HyperSphere)
+ * @param max_points The maximum number of points to sample
+ * @param function The function to integrate
+ * @param domain The domain object representing the integration domain
+ * @param variance Output parameter to store the computed variance
+ * @param points_used Output parameter to store the number of points actually sampled
+ * @param rule The stopping rule, absolute or relative tolerance
+ * @param tolerance The target of the 95% confidence interval half-width
+ * @param block_size The number of points sampled and evaluated together with one bulk call,
+ * 1 evaluates the function point by point
+ * @param seed The seed of the random streams
+ * @param single_precision True to draw the blocks as float32 numbers, the evaluation
+ * and the accumulation stay in double
+ * @return A pair containing the estimated integral value and the computation time in microseconds
+ */
+template <typename DomainType>
+std::pair<double, double> adaptiveMontecarloIntegration(size_t max_points,
+                                                        const std::string &function,
+                                                        DomainType &domain,
+                                                        double &variance,
+                                                        size_t &points_used,
+                                                        StoppingRule rule,
+                                                        double tolerance,
+                                                        size_t block_size = 1,
+                                                        uint64_t seed = 0,
+                                                        bool single_precision = false)
+{
+    // Initialization
+    size_t chunk_size = block_size > 1 ? block_size : POINTS_PER_CHUNK;
+    size_t max_chunks = (max_points + chunk_size - 1) / chunk_size;
+    std::vector<RunningStatistics> chunk_statistics;
+    RunningStatistics total;
+
+    domain.calculateVolume();
+    double volume = domain.getVolume();
+    double integral = 0.0;
+
+    std::cout << "Computing integral..." << std::endl;
+
+    // Start the timer
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t done_chunks = 0;
+    size_t round_points = std::min(max_points, std::max(FIRST_ROUND_POINTS, chunk_size));
+    for (size_t round = 1; done_chunks < max_chunks; ++round)
+    {
+        // Sample the next round of chunks in parallel
+        size_t last_chunk = std::min(max_chunks, done_chunks + (round_points + chunk_size - 1) / chunk_size);
+        chunk_statistics.assign(last_chunk - done_chunks, RunningStatistics());
+        evaluateChunks(function, domain, block_size, chunk_size, done_chunks, last_chunk,
+                       [&](size_t c, std::vector<double> &block, size_t stride, std::vector<double> &scratch)
+                       {
+                           size_t count = std::min(chunk_size, max_points - c * chunk_size);
+                           RandomStream stream(seed, c, single_precision);
+                           domain.generateRandomBlock(block, stride, count, stream, scratch);
+                           return count;
+                       },
+                       chunk_statistics);
+
+        // Merge the new chunks in order
+        for (size_t c = done_chunks; c < last_chunk; ++c)
+            total.merge(chunk_statistics[c - done_chunks]);
+        done_chunks = last_chunk;
+
+        integral = total.getMean() * volume;
+        double standard_error = total.getStandardError() * volume;
+        std::cout << "Round " << round << ": " << total.getCount() << " points, integral " << integral
+                  << " +/- " << 1.96 * standard_error << std::endl;
+
+        if (targetPrecisionReached(integral, standard_error, rule, tolerance))
+            break;
+
+        round_points = nextRoundSize(total.getCount(), max_points, integral, standard_error, rule, tolerance, chunk_size);
+    }
+
+    // Stop the timer
+    auto end = std::chrono::high_resolution_clock::now();
+
+    variance    = total.getVariance();
+    points_used = total.getCount();
 
     // Compute time taken
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
-    // Return the estimated integral value and standard error
+    // Return the estimated integral value and the computation time
     return std::make_pair(integral, static_cast<double>(duration.count()));
 }
 
@@ -0,0 +1,143 @@
+/**
+ * @file qmcsequence.hpp
+ * @brief This file contains the declaration of the low-discrepancy sequences used by the quasi-Monte Carlo mode.
+ */
+
+#ifndef PROJECT_QMCSEQUENCE_
+    #define PROJECT_QMCSEQUENCE_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "randomstream.hpp"
+
+/**
+ * @brief The way the sample points of the Monte Carlo integration are generated
+ */
+enum class SamplingMode
+{
+    PseudoRandom,
+    Sobol,
+    Halton
+};
+
+/**
+ * @class QmcSequence
+ * @brief Represents a randomized low-discrepancy sequence in the unit cube.
+ *
+ * This abstract class is used to represent a randomized quasi-Monte Carlo
+ * sequence. Any point can be generated directly from its index, so every
+ * thread can skip ahead to the start of its own chunk of points. Two
+ * instances built with different replicate indices are independent
+ * randomizations of the same sequence.
+ */
+class QmcSequence
+{
+public:
+    /**
+     * @brief Generate a block of consecutive points of the sequence
+     * @details The coordinate j of the point first + k is stored in
+     * block[j * block_size + k], in [0, 1).
+     * @param block Vector to store the coordinates, at least dimension * block_size long
+     * @param block_size The stride between two coordinates of the same point
+     * @param first The index of the first point of the block
+     * @param count The number of points to generate, at most block_size
+     */
+    virtual void generateBlock(std::vector<double> &block, size_t block_size, uint64_t first, size_t count) const = 0;
+
+    /**
+     * @brief Get the dimension of the sequence
+     * @return The number of coordinates of every point
+     */
+    inline size_t getDimension() const { return dimension; }
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~QmcSequence() {}
+
+protected:
+    size_t dimension;
+};
+
+/**
+ * @class SobolSequence
+ * @brief Owen-scrambled Sobol sequence with the Joe-Kuo direction numbers.
+ *
+ * The points are generated in Gray code order with 32-bit direction numbers,
+ * so a replicate holds at most MAX_POINTS = 2^32 points. Every coordinate is then
+ * scrambled with the hash-based nested uniform scrambling of Burley
+ * ("Practical Hash-based Owen Scrambling", JCGT 2020), seeded per
+ * dimension and per replicate.
+ */
+class SobolSequence: public QmcSequence
+{
+public:
+    /**
+     * @brief The maximum dimension covered by the direction number table
+     */
+    static constexpr size_t MAX_DIMENSION = 1024;
+
+    /**
+     * @brief The number of points of a replicate, the indices stay below 2^32
+     */
+    static constexpr uint64_t MAX_POINTS = uint64_t(1) << 32;
+
+    /**
+     * @brief Construct a new SobolSequence object
+     * @param dim The dimension of the sequence, at most MAX_DIMENSION
+     * @param seed The user seed
+     * @param replicate The index of the randomization
+     */
+    SobolSequence(size_t dim, uint64_t seed, uint64_t replicate);
+
+    void generateBlock(std::vector<double> &block, size_t block_size, uint64_t first, size_t count) const override;
+
+private:
+    std::vector<uint32_t> directions;
+    std::vector<uint32_t> scramble_seeds;
+};
+
+/**
+ * @class HaltonSequence
+ * @brief Randomly shifted Halton sequence.
+ *
+ * The coordinate j is the radical inverse of the index in the j-th prime
+ * base, shifted modulo 1 by a random amount per dimension and per replicate
+ * (Cranley-Patterson rotation). The projections on large bases are poorly
+ * distributed, so it is meant for low dimensions; use Sobol above about 20.
+ */
+class HaltonSequence: public QmcSequence
+{
+public:
+    /**
+     * @brief Construct a new HaltonSequence object
+     * @param dim The dimension of the sequence
+     * @param seed The user seed
+     * @param replicate The index of the randomization
+     */
+    HaltonSequence(size_t dim, uint64_t seed, uint64_t replicate);
+
+    void generateBlock(std::vector<double> &block, size_t block_size, uint64_t first, size_t count) const override;
+
+private:
+    std::vector<uint64_t> bases;
+    std::vector<double> shifts;
+};
+
+/**
+ * @brief Create the randomized sequence of a sampling mode
+ * @param mode The sampling mode, Sobol or Halton
+ * @param dim The dimension of the sequence
+ * @param seed The user seed
+ * @param replicate The index of the randomization
+ * @return A pointer to the sequence, nullptr for the pseudo-random mode
+ */
+QmcSequence *qmcSequenceFactory(SamplingMode mode, size_t dim, uint64_t seed, uint64_t replicate);
+
+  // Tables of the Sobol direction numbers, defined in soboldirections.cpp
+extern const unsigned short SOBOL_POLYNOMIALS[SobolSequence::MAX_DIMENSION - 1];
+extern const unsigned short SOBOL_INITIAL_NUMBERS[];
+
+#endif
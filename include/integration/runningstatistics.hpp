@@ -0,0 +1,345 @@
+/**
+ * @file runningstatistics.hpp
+ * @brief This file contains the declaration of the RunningStatistics class and of the stopping rules.
+ */
+
+#ifndef PROJECT_RUNNINGSTATISTICS_
+    #define PROJECT_RUNNINGSTATISTICS_
+
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * @brief The rule deciding when a Monte Carlo estimation stops
+ */
+enum class StoppingRule
+{
+    FixedPoints,        /**< Use exactly the requested number of samples */
+    AbsoluteTolerance,  /**< Stop when the 95% CI half-width is below the tolerance */
+    RelativeTolerance   /**< Stop when the 95% CI half-width is below the tolerance times |estimate| */
+};
+
+/**
+ * @brief The number of elements summed directly by pairwiseSum
+ */
+constexpr size_t PAIRWISE_BASE = 128;
+
+/**
+ * @brief Sum an array with pairwise summation
+ * @details The array is split in halves recursively down to PAIRWISE_BASE
+ * elements, which are summed in a SIMD loop, so the rounding error grows with
+ * log(n) instead of n. Single precision inputs are accumulated in double.
+ * @tparam T The type of the elements, float or double
+ * @param x The array
+ * @param n The number of elements
+ * @return The sum of the elements
+ */
+template <typename T>
+inline double pairwiseSum(const T *x, size_t n)
+{
+    if (n <= PAIRWISE_BASE)
+    {
+        double sum = 0.0;
+#pragma omp simd reduction(+ : sum)
+        for (size_t k = 0; k < n; ++k)
+            sum += static_cast<double>(x[k]);
+        return sum;
+    }
+
+    size_t half = n / 2;
+    return pairwiseSum(x, half) + pairwiseSum(x + half, n - half);
+}
+
+/**
+ * @class RunningStatistics
+ * @brief Numerically stable running mean and variance.
+ *
+ * Samples are added with Welford's update and two partial statistics are
+ * combined with the pairwise formula of Chan, Golub and LeVeque, so every
+ * thread or chunk can accumulate its own statistics and merge them at the
+ * end without forming sum(x^2) - sum(x)^2 / n. The updates of the mean and of
+ * the sum of squared deviations are Kahan compensated, so the error does not
+ * grow with the number of updates even after 1e10 samples or millions of
+ * merged chunks. The compensation needs value-safe floating point, it is
+ * optimized away by -ffast-math.
+ */
+class RunningStatistics
+{
+public:
+    RunningStatistics()
+        :  count(0), mean(0.0), m2(0.0), mean_compensation(0.0), m2_compensation(0.0) {}
+
+    /**
+     * @brief Add one sample
+     * @param x The sample
+     */
+    inline void add(double x)
+    {
+        ++count;
+        double delta = x - mean;
+        compensatedAdd(mean, mean_compensation, delta / static_cast<double>(count));
+        compensatedAdd(m2, m2_compensation, delta * (x - mean));
+    }
+
+    /**
+     * @brief Add the statistics of a block of samples, computed with two passes
+     * @details The mean comes from a pairwise sum and the squared deviations
+     * from it are accumulated in double, also for single precision samples.
+     * @tparam T The type of the samples, float or double
+     * @param x The samples
+     * @param n The number of samples
+     */
+    template <typename T>
+    inline void addBlock(const T *x, size_t n)
+    {
+        if (n == 0)
+            return;
+
+        RunningStatistics block;
+        block.count = n;
+        block.mean  = pairwiseSum(x, n) / static_cast<double>(n);
+
+        double block_mean = block.mean;
+        double squares    = 0.0;
+#pragma omp simd reduction(+ : squares)
+        for (size_t k = 0; k < n; ++k)
+            squares += (static_cast<double>(x[k]) - block_mean) * (static_cast<double>(x[k]) - block_mean);
+        block.m2 = squares;
+
+        merge(block);
+    }
+
+    /**
+     * @brief Merge the statistics of another set of samples
+     * @param other The statistics to merge
+     */
+    inline void merge(const RunningStatistics &other)
+    {
+        if (other.count == 0)
+            return;
+
+        size_t total = count + other.count;
+        double delta = other.mean - mean;
+        compensatedAdd(mean, mean_compensation, delta * static_cast<double>(other.count) / static_cast<double>(total));
+        compensatedAdd(m2, m2_compensation, other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / static_cast<double>(total));
+        count = total;
+    }
+
+    /**
+     * @brief Get the number of samples
+     * @return The number of samples added so far
+     */
+    inline size_t getCount() const { return count; }
+
+    /**
+     * @brief Get the mean of the samples
+     * @return The sample mean
+     */
+    inline double getMean() const { return mean; }
+
+    /**
+     * @brief Get the variance of the samples
+     * @return The population variance m2 / n, as used by the Monte Carlo estimators
+     */
+    inline double getVariance() const { return count > 0 ? m2 / static_cast<double>(count) : 0.0; }
+
+    /**
+     * @brief Get the standard error of the mean
+     * @return sqrt(variance / n)
+     */
+    inline double getStandardError() const { return count > 0 ? std::sqrt(getVariance() / static_cast<double>(count)) : 0.0; }
+
+    /**
+     * @brief Build the statistics of a set of samples from its moments
+     * @param count The number of samples
+     * @param mean The mean of the samples
+     * @param variance The population variance of the samples
+     * @return The statistics, ready to be merged
+     */
+    static inline RunningStatistics fromMoments(size_t count, double mean, double variance)
+    {
+        RunningStatistics statistics;
+        statistics.count = count;
+        statistics.mean  = mean;
+        statistics.m2    = variance * static_cast<double>(count);
+        return statistics;
+    }
+
+private:
+      // Kahan summation: the compensation keeps the low order bits lost by the previous updates
+    static inline void compensatedAdd(double &sum, double &compensation, double value)
+    {
+        double y = value - compensation;
+        double t = sum + y;
+        compensation = (t - sum) - y;
+        sum = t;
+    }
+
+    size_t count;
+    double mean;
+    double m2;
+    double mean_compensation;
+    double m2_compensation;
+};
+
+/**
+ * @class RunningCovariance
+ * @brief Running means, variances and covariance of pairs of samples.
+ *
+ * The bivariate version of RunningStatistics, used by the control variates: blocks
+ * are added with two passes and partial statistics are merged with the pairwise
+ * formulas of Chan, Golub and LeVeque. There is no compensation, the statistics are
+ * meant to be merged per block, not per sample.
+ */
+class RunningCovariance
+{
+public:
+    RunningCovariance()
+        :  count(0), mean_x(0.0), mean_y(0.0), m2_x(0.0), m2_y(0.0), c_xy(0.0) {}
+
+    /**
+     * @brief Add a block of pairs of samples
+     * @tparam T The type of the samples, float or double
+     * @param x The first samples
+     * @param y The second samples
+     * @param n The number of pairs
+     */
+    template <typename T>
+    inline void addBlock(const T *x, const T *y, size_t n)
+    {
+        if (n == 0)
+            return;
+
+        RunningCovariance block;
+        block.count  = n;
+        block.mean_x = pairwiseSum(x, n) / static_cast<double>(n);
+        block.mean_y = pairwiseSum(y, n) / static_cast<double>(n);
+
+        double bx = block.mean_x, by = block.mean_y;
+        double sxx = 0.0, syy = 0.0, sxy = 0.0;
+#pragma omp simd reduction(+ : sxx, syy, sxy)
+        for (size_t k = 0; k < n; ++k)
+        {
+            double dx = static_cast<double>(x[k]) - bx;
+            double dy = static_cast<double>(y[k]) - by;
+            sxx += dx * dx;
+            syy += dy * dy;
+            sxy += dx * dy;
+        }
+        block.m2_x = sxx;
+        block.m2_y = syy;
+        block.c_xy = sxy;
+
+        merge(block);
+    }
+
+    /**
+     * @brief Merge the statistics of another set of pairs
+     * @param other The statistics to merge
+     */
+    inline void merge(const RunningCovariance &other)
+    {
+        if (other.count == 0)
+            return;
+
+        double n_a = static_cast<double>(count), n_b = static_cast<double>(other.count);
+        double total = n_a + n_b;
+        double dx = other.mean_x - mean_x;
+        double dy = other.mean_y - mean_y;
+
+        mean_x += dx * n_b / total;
+        mean_y += dy * n_b / total;
+        m2_x   += other.m2_x + dx * dx * n_a * n_b / total;
+        m2_y   += other.m2_y + dy * dy * n_a * n_b / total;
+        c_xy   += other.c_xy + dx * dy * n_a * n_b / total;
+        count  += other.count;
+    }
+
+    /**
+     * @brief Get the number of pairs
+     * @return The number of pairs added so far
+     */
+    inline size_t getCount() const { return count; }
+
+    /**
+     * @brief Get the statistics of the first samples alone
+     * @return The statistics of x
+     */
+    inline RunningStatistics getStatisticsX() const { return RunningStatistics::fromMoments(count, mean_x, getVarianceX()); }
+
+    /**
+     * @brief Get the means of the samples
+     * @return The mean of x or of y
+     */
+    inline double getMeanX() const { return mean_x; }
+    inline double getMeanY() const { return mean_y; }
+
+    /**
+     * @brief Get the variances of the samples
+     * @return The population variance of x or of y
+     */
+    inline double getVarianceX() const { return count > 0 ? m2_x / static_cast<double>(count) : 0.0; }
+    inline double getVarianceY() const { return count > 0 ? m2_y / static_cast<double>(count) : 0.0; }
+
+    /**
+     * @brief Get the covariance of the pairs
+     * @return The population covariance of x and y
+     */
+    inline double getCovariance() const { return count > 0 ? c_xy / static_cast<double>(count) : 0.0; }
+
+private:
+    size_t count;
+    double mean_x;
+    double mean_y;
+    double m2_x;
+    double m2_y;
+    double c_xy;
+};
+
+/**
+ * @brief Check whether an estimate meets its target precision
+ * @param estimate The current estimate
+ * @param standard_error The standard error of the estimate
+ * @param rule The stopping rule
+ * @param tolerance The absolute or relative tolerance on the 95% CI half-width
+ * @return True if the 95% confidence interval half-width meets the target
+ */
+inline bool targetPrecisionReached(double estimate, double standard_error, StoppingRule rule, double tolerance)
+{
+    double half_width = 1.96 * standard_error;
+
+    if (rule == StoppingRule::AbsoluteTolerance)
+        return half_width <= tolerance;
+    if (rule == StoppingRule::RelativeTolerance)
+        return half_width <= tolerance * std::fabs(estimate);
+    return false;
+}
+
+/**
+ * @brief Choose the number of samples of the next adaptive round
+ * @details The squared ratio between the current and the target half-width
+ * estimates the samples still needed; the round is at least min_round and
+ * at most three times the samples used so far, then it is capped by the
+ * samples left.
+ * @param used The samples used so far
+ * @param max_samples The sample cap
+ * @param estimate The current estimate
+ * @param standard_error The current standard error
+ * @param rule The stopping rule
+ * @param tolerance The absolute or relative tolerance on the 95% CI half-width
+ * @param min_round The minimum size of a round
+ * @return The number of samples of the next round
+ */
+inline size_t nextRoundSize(size_t used, size_t max_samples, double estimate, double standard_error, StoppingRule rule, double tolerance, size_t min_round)
+{
+    double target = rule == StoppingRule::RelativeTolerance ? tolerance * std::fabs(estimate) : tolerance;
+    double ratio  = target > 0.0 ? 1.96 * standard_error / target : 2.0;
+    double needed = 1.1 * ratio * ratio * static_cast<double>(used) - static_cast<double>(used);
+
+    size_t round = static_cast<size_t>(std::fmin(std::fmax(needed, static_cast<double>(min_round)), 3.0 * static_cast<double>(used)));
+    round = std::max(round, min_round);
+    return std::min(round, max_samples - used);
+}
+
+#endif
@@ -0,0 +1,503 @@
+/**
+ * @file vectormath.hpp
+ * @brief This file contains branch-free elementary functions that vectorize inside SIMD loops.
+ */
+
+#ifndef PROJECT_VECTORMATH_
+    #define PROJECT_VECTORMATH_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+/**
+ * @brief Reinterpret the bits of a double as an unsigned integer
+ * @param x The double to reinterpret
+ * @return The IEEE-754 representation of x
+ */
+inline uint64_t doubleToBits(double x)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Reinterpret an unsigned integer as a double
+ * @param bits The IEEE-754 representation of the double
+ * @return The double represented by bits
+ */
+inline double bitsToDouble(uint64_t bits)
+{
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/**
+ * @brief Reinterpret the bits of a float as an unsigned integer
+ * @param x The float to reinterpret
+ * @return The IEEE-754 representation of x
+ */
+inline uint32_t floatToBits(float x)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Reinterpret an unsigned integer as a float
+ * @param bits The IEEE-754 representation of the float
+ * @return The float represented by bits
+ */
+inline float bitsToFloat(uint32_t bits)
+{
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/**
+ * @brief Compute 2^k for an integral valued double k in [-1022, 1023]
+ * @details Adding 2^52 + 1023 stores the biased exponent in the low mantissa bits,
+ * the shift then moves it into the exponent field.
+ * @param k The exponent, already rounded to an integer
+ * @return The value 2^k
+ */
+inline double simdPow2(double k)
+{
+    return bitsToDouble(doubleToBits(k + 4503599627371519.0) << 52);
+}
+
+/**
+ * @brief Exponential function for |x| <= 708
+ * @details Cody-Waite reduction x = k ln2 + r with |r| <= ln2/2 followed by a
+ * degree 13 Taylor polynomial, accurate to about one ulp. The function has no
+ * branches, so loops calling it vectorize.
+ * @param x The argument, |x| <= 708
+ * @return The value of exp(x)
+ */
+inline double simdExp(double x)
+{
+    constexpr double LOG2E  = 1.4426950408889634074;
+    constexpr double LN2_HI = 6.93147180369123816490e-01;
+    constexpr double LN2_LO = 1.90821492927058770002e-10;
+
+    double k = std::rint(x * LOG2E);
+    double r = (x - k * LN2_HI) - k * LN2_LO;
+
+    double p = 1.0 / 6227020800.0;
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    return p * simdPow2(k);
+}
+
+/**
+ * @brief Compute 2^k for an integral valued float k in [-126, 127]
+ * @param k The exponent, already rounded to an integer
+ * @return The value 2^k
+ */
+inline float simdPow2(float k)
+{
+    return bitsToFloat(floatToBits(k + 8388735.0f) << 23);
+}
+
+/**
+ * @brief Single precision exponential function for |x| <= 87
+ * @details Same reduction as the double version with a degree 7 Taylor
+ * polynomial, accurate to about one float ulp.
+ * @param x The argument, |x| <= 87
+ * @return The value of exp(x)
+ */
+inline float simdExp(float x)
+{
+    constexpr float LOG2E  = 1.44269504f;
+    constexpr float LN2_HI = 0.693359375f;
+    constexpr float LN2_LO = -2.12194440e-4f;
+
+    float k = std::rint(x * LOG2E);
+    float r = (x - k * LN2_HI) - k * LN2_LO;
+
+    float p = 1.0f / 5040.0f;
+    p = p * r + 1.0f / 720.0f;
+    p = p * r + 1.0f / 120.0f;
+    p = p * r + 1.0f / 24.0f;
+    p = p * r + 1.0f / 6.0f;
+    p = p * r + 0.5f;
+    p = p * r + 1.0f;
+    p = p * r + 1.0f;
+
+    return p * simdPow2(k);
+}
+
+/**
+ * @brief Natural logarithm for normal, positive and finite x
+ * @details The argument is split into 2^e * m with m in [sqrt(1/2), sqrt(2)),
+ * then log(m) = 2 atanh((m - 1) / (m + 1)) is evaluated with its odd series.
+ * @param x The argument, a positive normal double
+ * @return The value of log(x)
+ */
+inline double simdLog(double x)
+{
+    constexpr double LN2_HI = 6.93147180369123816490e-01;
+    constexpr double LN2_LO = 1.90821492927058770002e-10;
+
+      // Offsetting the bits by 1.0 - sqrt(1/2) makes the exponent field hold e
+      // and leaves the mantissa of m = x / 2^e in [sqrt(1/2), sqrt(2))
+    uint64_t bits = doubleToBits(x) + 0x00095F619980C433ULL;
+
+      // Exponent as a double: place the biased exponent in the mantissa of 2^52
+    double e = bitsToDouble((bits >> 52) | 0x4330000000000000ULL) - 4503599627371519.0;
+    double m = bitsToDouble((bits & 0x000FFFFFFFFFFFFFULL) + 0x3FE6A09E667F3BCDULL);
+
+    double f = (m - 1.0) / (m + 1.0);
+    double s = f * f;
+
+    double p = 1.0 / 23.0;
+    p = p * s + 1.0 / 21.0;
+    p = p * s + 1.0 / 19.0;
+    p = p * s + 1.0 / 17.0;
+    p = p * s + 1.0 / 15.0;
+    p = p * s + 1.0 / 13.0;
+    p = p * s + 1.0 / 11.0;
+    p = p * s + 1.0 / 9.0;
+    p = p * s + 1.0 / 7.0;
+    p = p * s + 1.0 / 5.0;
+    p = p * s + 1.0 / 3.0;
+
+    return e * LN2_HI + (2.0 * f + (2.0 * f * s * p + e * LN2_LO));
+}
+
+/**
+ * @brief Single precision natural logarithm for normal, positive and finite x
+ * @details Same splitting as the double version with a shorter series.
+ * @param x The argument, a positive normal float
+ * @return The value of log(x)
+ */
+inline float simdLog(float x)
+{
+    constexpr float LN2_HI = 0.693359375f;
+    constexpr float LN2_LO = -2.12194440e-4f;
+
+    uint32_t bits = floatToBits(x) + 0x004AFB0Du;
+
+    float e = static_cast<float>(static_cast<int32_t>(bits >> 23)) - 127.0f;
+    float m = bitsToFloat((bits & 0x007FFFFFu) + 0x3F3504F3u);
+
+    float f = (m - 1.0f) / (m + 1.0f);
+    float s = f * f;
+
+    float p = 1.0f / 11.0f;
+    p = p * s + 1.0f / 9.0f;
+    p = p * s + 1.0f / 7.0f;
+    p = p * s + 1.0f / 5.0f;
+    p = p * s + 1.0f / 3.0f;
+
+    return e * LN2_HI + (2.0f * f + (2.0f * f * s * p + e * LN2_LO));
+}
+
+/**
+ * @brief Sine and cosine kernels on [-pi/4, pi/4] (fdlibm coefficients)
+ */
+inline double simdSinKernel(double r)
+{
+    double z = r * r;
+    double p = 1.58969099521155010221e-10;
+    p = p * z - 2.50507602534068634195e-08;
+    p = p * z + 2.75573137070700676789e-06;
+    p = p * z - 1.98412698298579493134e-04;
+    p = p * z + 8.33333333332248946124e-03;
+    p = p * z - 1.66666666666666324348e-01;
+    return r + r * z * p;
+}
+
+inline double simdCosKernel(double r)
+{
+    double z = r * r;
+    double p = -1.13596475577881948265e-11;
+    p = p * z + 2.08757232129817482790e-09;
+    p = p * z - 2.75573143513906633035e-07;
+    p = p * z + 2.48015872894767294178e-05;
+    p = p * z - 1.38888888888741095749e-03;
+    p = p * z + 4.16666666666666019037e-02;
+    double hz = 0.5 * z;
+    double w  = 1.0 - hz;
+    return w + (((1.0 - w) - hz) + z * z * p);
+}
+
+/**
+ * @brief Sine (quadrant_shift = 0) or cosine (quadrant_shift = 1) for |x| <= 1e5
+ * @details Three-part Cody-Waite reduction by pi/2, then the quadrant selects
+ * the kernel and the sign without branching.
+ * @param x The argument, |x| <= 1e5
+ * @param quadrant_shift 0 for the sine, 1 for the cosine
+ * @return The value of sin(x) or cos(x)
+ */
+inline double simdSinCos(double x, double quadrant_shift)
+{
+    constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+    constexpr double PIO2_1      = 1.57079632673412561417e+00;
+    constexpr double PIO2_2      = 6.07710050630396597660e-11;
+    constexpr double PIO2_3      = 2.02226624871116645580e-21;
+
+    double q = std::rint(x * TWO_OVER_PI);
+    double r = ((x - q * PIO2_1) - q * PIO2_2) - q * PIO2_3;
+
+      // Quadrant modulo 4 as t in {-2, -1, 0, 1, 2}, kept as a double so the
+      // selects stay in double lanes; they only pick constants, and the blend
+      // below is exact since one of its weights is zero
+    double shifted = q + quadrant_shift;
+    double t       = shifted - 4.0 * std::rint(shifted * 0.25);
+    double use_cos = std::fabs(t) == 1.0 ? 1.0 : 0.0;
+    double sign    = (std::fabs(t) == 2.0 ? -1.0 : 1.0) * (t == -1.0 ? -1.0 : 1.0);
+
+    double s = simdSinKernel(r);
+    double c = simdCosKernel(r);
+    return sign * (use_cos * c + (1.0 - use_cos) * s);
+}
+
+inline double simdSin(double x) { return simdSinCos(x, 0.0); }
+inline double simdCos(double x) { return simdSinCos(x, 1.0); }
+
+/**
+ * @brief Sine and cosine of 2 pi u for u in [0, 1), sharing one reduction
+ * @details The quadrant comes from rint(4 u) and the remainder u - q / 4 is
+ * exact, so both kernels are evaluated once and the quadrant only swaps
+ * them and selects the signs. Used by the Box-Muller transforms.
+ * @param u The argument, in [0, 1)
+ * @param sine Output parameter to store sin(2 pi u)
+ * @param cosine Output parameter to store cos(2 pi u)
+ */
+inline void simdSinCosTwoPi(double u, double &sine, double &cosine)
+{
+    constexpr double TWO_PI = 6.28318530717958647693;
+
+    double q = std::rint(4.0 * u);
+    double r = TWO_PI * (u - 0.25 * q);
+    double s = simdSinKernel(r);
+    double c = simdCosKernel(r);
+
+      // Quadrants 1 and 3 swap the kernels, 2 and 3 flip the sine, 1 and 2 the cosine
+    double swap     = (q == 1.0 || q == 3.0) ? 1.0 : 0.0;
+    double sin_sign = (q == 2.0 || q == 3.0) ? -1.0 : 1.0;
+    double cos_sign = (q == 1.0 || q == 2.0) ? -1.0 : 1.0;
+
+    sine   = sin_sign * (swap * c + (1.0 - swap) * s);
+    cosine = cos_sign * (swap * s + (1.0 - swap) * c);
+}
+
+/**
+ * @brief Single precision sine and cosine of 2 pi u for u in [0, 1)
+ * @param u The argument, in [0, 1)
+ * @param sine Output parameter to store sin(2 pi u)
+ * @param cosine Output parameter to store cos(2 pi u)
+ */
+inline void simdSinCosTwoPi(float u, float &sine, float &cosine)
+{
+    constexpr float TWO_PI = 6.28318530717958647693f;
+
+    float q = std::rint(4.0f * u);
+    float r = TWO_PI * (u - 0.25f * q);
+    float z = r * r;
+
+    float ps = 1.0f / 362880.0f;
+    ps = ps * z - 1.0f / 5040.0f;
+    ps = ps * z + 1.0f / 120.0f;
+    ps = ps * z - 1.0f / 6.0f;
+    float s = r + r * z * ps;
+
+    float pc = 1.0f / 40320.0f;
+    pc = pc * z - 1.0f / 720.0f;
+    pc = pc * z + 1.0f / 24.0f;
+    pc = pc * z - 0.5f;
+    float c = 1.0f + z * pc;
+
+    float swap     = (q == 1.0f || q == 3.0f) ? 1.0f : 0.0f;
+    float sin_sign = (q == 2.0f || q == 3.0f) ? -1.0f : 1.0f;
+    float cos_sign = (q == 1.0f || q == 2.0f) ? -1.0f : 1.0f;
+
+    sine   = sin_sign * (swap * c + (1.0f - swap) * s);
+    cosine = cos_sign * (swap * s + (1.0f - swap) * c);
+}
+
+/**
+ * @brief Evaluate the rational function P(x) / Q(x) of two polynomials of degree 7
+ * @details The coefficients are in ascending powers and are passed by value, so the
+ * evaluation stays in registers inside SIMD loops.
+ */
+inline double simdRational7(double x,
+                            double p0, double p1, double p2, double p3, double p4, double p5, double p6, double p7,
+                            double q1, double q2, double q3, double q4, double q5, double q6, double q7)
+{
+    double p = ((((((p7 * x + p6) * x + p5) * x + p4) * x + p3) * x + p2) * x + p1) * x + p0;
+    double q = ((((((q7 * x + q6) * x + q5) * x + q4) * x + q3) * x + q2) * x + q1) * x + 1.0;
+    return p / q;
+}
+
+/**
+ * @brief Inverse of the standard normal distribution function for p in (0, 1)
+ * @details Algorithm AS241 of Wichura (PPND16), relative error about 1e-16. The
+ * central and the two tail rational approximations are all evaluated and the
+ * result is selected without branching.
+ * @param p The probability, in (0, 1)
+ * @return The value x such that Phi(x) = p
+ */
+inline double simdInverseNormalCdf(double p)
+{
+    double q = p - 0.5;
+
+      // Central region |q| <= 0.425
+    double r       = 0.180625 - q * q;
+    double central = q * simdRational7(r,
+                                       3.3871328727963666080e0, 1.3314166789178437745e+2, 1.9715909503065514427e+3, 1.3731693765509461125e+4,
+                                       4.5921953931549871457e+4, 6.7265770927008700853e+4, 3.3430575583588128105e+4, 2.5090809287301226727e+3,
+                                       4.2313330701600911252e+1, 6.8718700749205790830e+2, 5.3941960214247511077e+3, 2.1213794301586595867e+4,
+                                       3.9307895800092710610e+4, 2.8729085735721942674e+4, 5.2264952788528545610e+3);
+
+      // Tails, t = sqrt(-log(min(p, 1 - p))) split at 5
+    double t    = std::sqrt(-simdLog(q < 0.0 ? p : 1.0 - p));
+    double near = simdRational7(t - 1.6,
+                                1.42343711074968357734e0, 4.63033784615654529590e0, 5.76949722146069140550e0, 3.64784832476320460504e0,
+                                1.27045825245236838258e0, 2.41780725177450611770e-1, 2.27238449892691845833e-2, 7.74545014278341407640e-4,
+                                2.05319162663775882187e0, 1.67638483018380384940e0, 6.89767334985100004550e-1, 1.48103976427480074590e-1,
+                                1.51986665636164571966e-2, 5.47593808499534494600e-4, 1.05075007164441684324e-9);
+    double far  = simdRational7(t - 5.0,
+                                6.65790464350110377720e0, 5.46378491116411436990e0, 1.78482653991729133580e0, 2.96560571828504891230e-1,
+                                2.65321895265761230930e-2, 1.24266094738807843860e-3, 2.71155556874348757815e-5, 2.01033439929228813265e-7,
+                                5.99832206555887937690e-1, 1.36929880922735805310e-1, 1.48753612908506148525e-2, 7.86869131145613259100e-4,
+                                1.84631831751005468180e-5, 1.42151175831644588870e-7, 2.04426310338993978564e-15);
+    double tail = (t <= 5.0 ? near : far) * (q < 0.0 ? -1.0 : 1.0);
+
+    return std::fabs(q) <= 0.425 ? central : tail;
+}
+
+/**
+ * @brief Apply exp to an array
+ * @details Uses the SIMD kernel when every element is in its range and
+ * falls back to std::exp otherwise. in and out may alias.
+ * @param in The input array
+ * @param out The output array
+ * @param n The number of elements
+ */
+inline void vectorExp(const double *in, double *out, size_t n)
+{
+    size_t out_of_range = 0;
+#pragma omp simd reduction(+ : out_of_range)
+    for (size_t k = 0; k < n; ++k)
+        out_of_range += !(std::fabs(in[k]) <= 708.0);
+
+    if (out_of_range == 0)
+    {
+#pragma omp simd
+        for (size_t k = 0; k < n; ++k)
+            out[k] = simdExp(in[k]);
+    }
+    else
+    {
+        for (size_t k = 0; k < n; ++k)
+            out[k] = std::exp(in[k]);
+    }
+}
+
+/**
+ * @brief Apply log to an array
+ * @details Uses the SIMD kernel when every element is a positive normal
+ * double and falls back to std::log otherwise. in and out may alias.
+ * @param in The input array
+ * @param out The output array
+ * @param n The number of elements
+ */
+inline void vectorLog(const double *in, double *out, size_t n)
+{
+    size_t out_of_range = 0;
+#pragma omp simd reduction(+ : out_of_range)
+    for (size_t k = 0; k < n; ++k)
+    {
+        out_of_range += !(in[k] >= 2.2250738585072014e-308);
+        out_of_range += !(in[k] <= 1.7976931348623157e308);
+    }
+
+    if (out_of_range == 0)
+    {
+#pragma omp simd
+        for (size_t k = 0; k < n; ++k)
+            out[k] = simdLog(in[k]);
+    }
+    else
+    {
+        for (size_t k = 0; k < n; ++k)
+            out[k] = std::log(in[k]);
+    }
+}
+
+/**
+ * @brief Apply sin to an array
+ * @details Uses the SIMD kernel when every |element| <= 1e5 and falls back
+ * to std::sin otherwise. in and out may alias.
+ * @param in The input array
+ * @param out The output array
+ * @param n The number of elements
+ */
+inline void vectorSin(const double *in, double *out, size_t n)
+{
+    size_t out_of_range = 0;
+#pragma omp simd reduction(+ : out_of_range)
+    for (size_t k = 0; k < n; ++k)
+        out_of_range += !(std::fabs(in[k]) <= 1e5);
+
+    if (out_of_range == 0)
+    {
+#pragma omp simd
+        for (size_t k = 0; k < n; ++k)
+            out[k] = simdSin(in[k]);
+    }
+    else
+    {
+        for (size_t k = 0; k < n; ++k)
+            out[k] = std::sin(in[k]);
+    }
+}
+
+/**
+ * @brief Apply cos to an array
+ * @details Uses the SIMD kernel when every |element| <= 1e5 and falls back
+ * to std::cos otherwise. in and out may alias.
+ * @param in The input array
+ * @param out The output array
+ * @param n The number of elements
+ */
+inline void vectorCos(const double *in, double *out, size_t n)
+{
+    size_t out_of_range = 0;
+#pragma omp simd reduction(+ : out_of_range)
+    for (size_t k = 0; k < n; ++k)
+        out_of_range += !(std::fabs(in[k]) <= 1e5);
+
+    if (out_of_range == 0)
+    {
+#pragma omp simd
+        for (size_t k = 0; k < n; ++k)
+            out[k] = simdCos(in[k]);
+    }
+    else
+    {
+        for (size_t k = 0; k < n; ++k)
+            out[k] = std::cos(in[k]);
+    }
+}
+
+#endif
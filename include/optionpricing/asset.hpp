@@ -117,7 +117,7 @@ public:
      * @brief Set the daily returns of the asset.
      * @param daily_returns A vector of doubles representing the daily returns of the asset.
      */
-    void setDailyReturns(std::vector<double> daily_returns) { this->daily_returns = daily_returns; }
+    void setDailyReturns(std::vector<double> daily_returns) { this->daily_returns = std::move(daily_returns); }
 
 private:
     std::string name;
@@ -0,0 +1,63 @@
+/**
+ * @file finance_bridge.hpp
+ * @brief This file contains the declaration of the BrownianBridge class.
+ */
+
+#ifndef PROJECT_FINANCEBRIDGE_HPP
+    #define PROJECT_FINANCEBRIDGE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+
+  /**
+ * @class BrownianBridge
+ * @brief Brownian bridge construction of the Brownian paths over a uniform time grid.
+ *
+ * The first standard normal number sets the value of the path at the last step,
+ * the next ones fill the midpoints of the intervals still unknown, conditionally on
+ * their two ends. Most of the variance of the path, and of path dependent payoffs such
+ * as the average price, is therefore carried by the first numbers, which is where a
+ * low-discrepancy sequence is the most uniform. The construction works for any number
+ * of steps and on whole blocks of paths at once.
+ */
+class BrownianBridge
+{
+public:
+    /**
+     * @brief Construct a new BrownianBridge object
+     * @param num_steps The number of time steps of the paths
+     */
+    explicit BrownianBridge(size_t num_steps);
+
+    /**
+     * @brief Build the increments of a block of paths from their standard normal numbers
+     * @details The number i of the bridge of the path p is normals[i * stride + p]. The
+     * increment of the step s of the path p, stored in increments[s * paths + p], is a
+     * standard normal number: the paths are built in units of the time step.
+     * @tparam T The floating point type of the increments, float or double
+     * @param normals The standard normal numbers, in the order of the bridge
+     * @param stride The distance between two consecutive numbers of the same path
+     * @param paths The number of paths of the block
+     * @param increments The array to store the increments, at least num_steps * paths long
+     */
+    template <typename T>
+    void build(const double *normals, size_t stride, size_t paths, T *increments) const;
+
+    /**
+     * @brief Get the number of steps
+     * @return The number of time steps of the paths
+     */
+    inline size_t getNumSteps() const { return num_steps; }
+
+private:
+    size_t num_steps;
+    std::vector<size_t> bridge_index;
+    std::vector<size_t> left_index;
+    std::vector<size_t> right_index;
+    std::vector<double> left_weight;
+    std::vector<double> right_weight;
+    std::vector<double> std_dev;
+};
+
+#endif
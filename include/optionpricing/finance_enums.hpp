@@ -22,6 +22,22 @@ enum class OptionType {
     Invalid
 };
 
+// Enum for the payoff of a contract
+enum class PayoffType {
+    Call = 1, /**< max(0, basket - strike) */
+    Put,      /**< max(0, strike - basket) */
+    Invalid
+};
+
+// Enum for option book loading errors
+enum class LoadBookError
+{
+    Success,       /**< Indicates successful book loading */
+    FileOpenError, /**< Error opening the file */
+    InvalidLine,   /**< A line is not a valid contract */
+    NoContracts    /**< The file has no contracts */
+};
+
 // Enum for asset count types
 enum class AssetCountType {
     Single = 1,
@@ -29,12 +45,88 @@ enum class AssetCountType {
     Invalid
 };
 
+// Enum for the estimator of the price of the Asian options
+enum class Estimator {
+    SingleLevel = 1, /**< Every path on the full grid of days */
+    Multilevel,      /**< Telescoping sum of coupled coarse and fine grids */
+    Invalid
+};
+
+// Enum for the floating point precision of the path kernel
+enum class PathPrecision {
+    Double = 1,
+    Single,
+    Invalid
+};
+
+// Enum for the construction of the paths
+enum class PathConstruction {
+    PseudoRandom = 1,    /**< Step by step paths driven by pseudo-random numbers */
+    BrownianBridgeSobol, /**< Brownian bridge paths driven by a scrambled Sobol sequence */
+    Invalid
+};
+
+// Enum for the variance reduction applied on top of the antithetic paths
+enum class VarianceReduction {
+    None = 1,           /**< Antithetic paths only */
+    ControlVariate,     /**< Geometric Asian or final basket control variate */
+    ImportanceSampling, /**< Shift of the driving normals chosen by a pilot run */
+    Invalid
+};
+
+// Enum for market data file errors
+enum class MarketDataError {
+    Success,       /**< Indicates successful market data operation */
+    FileOpenError, /**< Error opening, creating or mapping the file */
+    InvalidFormat  /**< The file is not a market data file, is truncated or has an invalid row */
+};
+
+// Enum for statistics store errors
+enum class StatisticsStoreError {
+    Success,          /**< Indicates successful statistics store operation */
+    FileOpenError,    /**< Error opening, creating or mapping the file */
+    InvalidFormat,    /**< The file is not a statistics store or is truncated */
+    CovarianceFailure /**< The assets have different numbers of returns or less than two */
+};
+
+// Enum for the source of the paths of an option book
+enum class PathSource {
+    Simulate = 1,     /**< Simulate the paths and price the book on them */
+    SimulateAndStore, /**< Simulate the paths, store them in a binary file and price the book from it */
+    Stored,           /**< Price the book from the paths stored in a binary file */
+    Invalid
+};
+
+// Enum for the columns of a path store, every column holds one value per antithetic pair
+enum class PathColumn {
+    Final = 0,         /**< Final prices of the paths */
+    AntitheticFinal,   /**< Final prices of the antithetic paths */
+    Average,           /**< Averages of the prices over the days of the paths */
+    AntitheticAverage, /**< Averages of the prices over the days of the antithetic paths */
+    Count              /**< Number of columns per asset */
+};
+
+// Enum for path store errors
+enum class PathStoreError {
+    Success,          /**< Indicates successful path store operation */
+    FileOpenError,    /**< Error creating, opening or mapping the file */
+    InvalidFormat,    /**< The file is not a path store or is truncated */
+    SimulationFailed  /**< The covariance or its Cholesky factor could not be calculated */
+};
+
 // Enum for covariance calculation errors
 enum class CovarianceError {
     Success, /**< Indicates successful covariance calculation */
     Failure  /**< Indicates failure in covariance calculation */
 };
 
+// Enum for Cholesky factorization errors
+enum class CholeskyError {
+    Success,     /**< The matrix is positive-definite and has been factorized */
+    Regularized, /**< Some pivots were too small or negative and have been raised, the factor is the one of a nearby matrix */
+    Failure      /**< The matrix has non-finite entries or no positive diagonal entry */
+};
+
 // Enum for Monte Carlo simulation errors
 enum class MonteCarloError {
     Success,              /**< Indicates successful Monte Carlo simulation */
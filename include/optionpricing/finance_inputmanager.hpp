@@ -18,6 +18,10 @@
 #include "asset.hpp"
 #include "optionpricer.hpp"
 #include "finance_enums.hpp"
+#include "finance_marketdata.hpp"
+
+  // Defined in finance_montecarlo.hpp, which includes this header
+struct OptionContract;
 
   /**
  * @brief Calculate the log return of an asset.
@@ -31,20 +35,48 @@ double logReturn(const double price, const double previous_price);
   /**
  * @brief Extrapolate data from a CSV file.
  * @details This function reads the data from a CSV file and stores it in an Asset object.
+ *          The file is memory-mapped and the prices are parsed by parseCsvPriceLine
+ *          straight from the mapped bytes, without copying the lines; the mean and the
+ *          standard deviation of the log returns are accumulated in the same pass.
  * @param filename The name of the CSV file.
  * @param asset_ptr The pointer to the Asset object.
- * @return 0 if the function has been executed successfully.
+ * @return 0 if the function has been executed successfully, -1 if the file cannot be
+ *         opened or a price cannot be parsed.
  */
 int extrapolateCsvData(const std::string &filename, Asset *asset_ptr);
 
+  /**
+ * @brief Get the subdirectory of the files of the assets of an asset count type.
+ * @param asset_count_type The asset count type.
+ * @return The name of the subdirectory, empty for an invalid type.
+ */
+std::string assetSubdirectory(const AssetCountType &asset_count_type);
+
   /**
  * @brief Load assets from CSV files.
  * @details This function reads the data from CSV files in a specified directory
- *          and stores it in a vector of Asset objects.
+ *          and stores it in a vector of Asset objects. When a market data file
+ *          (same name, MARKET_DATA_EXTENSION) is next to a CSV file and is not older
+ *          than it, the asset is loaded from the memory-mapped market data file
+ *          instead of parsing the CSV file; a market data file without a CSV file
+ *          is loaded as well. The files are loaded in parallel, the assets keep the
+ *          order of the directory.
  * @param directory The directory where the CSV files are stored.
  * @param assets The vector that will contain the Asset objects.
  * @return A LoadAssetError value that indicates the status of the function.
  */
 LoadAssetError loadAssets(const std::string &directory, std::vector<Asset> &assets, const AssetCountType &asset_count_type);
 
+  /**
+ * @brief Load a book of option contracts from a CSV file.
+ * @details Every line after the header holds the strike as a multiple of the at-the-money
+ *          strike, the option type (European or Asian) and the payoff (Call or Put),
+ *          for example 1.05,Asian,Call.
+ * @param filename The name of the CSV file.
+ * @param at_the_money_strike The at-the-money strike price of the basket.
+ * @param contracts The vector that will contain the contracts.
+ * @return A LoadBookError value that indicates the status of the function.
+ */
+LoadBookError loadOptionBook(const std::string &filename, double at_the_money_strike, std::vector<OptionContract> &contracts);
+
 #endif
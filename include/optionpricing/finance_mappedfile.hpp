@@ -0,0 +1,76 @@
+/**
+ * @file finance_mappedfile.hpp
+ * @brief This file contains the declaration of the MappedFile class, a memory-mapped binary file.
+ */
+
+#ifndef PROJECT_FINANCEMAPPEDFILE_HPP
+    #define PROJECT_FINANCEMAPPEDFILE_HPP
+
+#include <string>
+#include <cstddef>
+
+  /**
+ * @class MappedFile
+ * @brief A binary file mapped in memory with mmap.
+ *
+ * A file opened for reading is mapped read-only and private: the pages are
+ * loaded on demand from the page cache, so reading a file again does not copy
+ * it and a file larger than the memory can still be scanned. A created file
+ * has its size fixed up front and is mapped shared, so the threads can write
+ * their parts of it in place and the data reaches the file when it is closed.
+ * The mapping is released by close or by the destructor; the object cannot be
+ * copied.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &)            = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Map an existing file for reading
+     * @param filename The name of the file
+     * @return True if the file has been opened and mapped, false otherwise or if it is empty
+     */
+    bool openRead(const std::string &filename);
+
+    /**
+     * @brief Create a file of the given size, or truncate an existing one, and map it for writing
+     * @param filename The name of the file
+     * @param size The size of the file in bytes, greater than 0
+     * @return True if the file has been created and mapped
+     */
+    bool create(const std::string &filename, size_t size);
+
+    /**
+     * @brief Release the mapping, the written data of a created file is kept in the file
+     */
+    void close();
+
+    /**
+     * @brief Get the mapped bytes
+     * @return The pointer to the first byte, nullptr if no file is mapped
+     */
+    const unsigned char *data() const { return mapping; }
+
+    /**
+     * @brief Get the mapped bytes of a created file
+     * @return The pointer to the first byte, nullptr if no file is mapped
+     */
+    unsigned char *data() { return mapping; }
+
+    /**
+     * @brief Get the size of the mapped file
+     * @return The size in bytes
+     */
+    size_t size() const { return length; }
+
+private:
+    unsigned char *mapping = nullptr;
+    size_t length          = 0;
+};
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file finance_marketdata.hpp
+ * @brief This file contains the declarations of the binary columnar market data format of the assets.
+ */
+
+#ifndef PROJECT_FINANCEMARKETDATA_HPP
+    #define PROJECT_FINANCEMARKETDATA_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+#include "asset.hpp"
+#include "finance_enums.hpp"
+#include "finance_mappedfile.hpp"
+#include "../integration/runningstatistics.hpp"
+
+  /**
+ * @brief The magic bytes at the start of a market data file
+ */
+constexpr char MARKET_DATA_MAGIC[8] = {'A', 'M', 'S', 'C', 'M', 'K', 'T', 'D'};
+
+  /**
+ * @brief The version of the market data format
+ */
+constexpr uint32_t MARKET_DATA_VERSION = 1;
+
+  /**
+ * @brief The extension of the market data files, written next to the CSV files
+ */
+constexpr const char *MARKET_DATA_EXTENSION = ".bin";
+
+  /**
+ * @brief The alignment in bytes of the start of the columns of a market data file
+ */
+constexpr size_t MARKET_DATA_ALIGNMENT = 64;
+
+  /**
+ * @struct MarketDataHeader
+ * @brief The header at the start of a market data file.
+ * @details The header is followed by four columns of num_rows values, every one starting at a
+ * multiple of MARKET_DATA_ALIGNMENT bytes: the dates (int32, yyyymmdd), the open prices, the
+ * close prices and the log returns log(close / open) (doubles). The statistics of the returns
+ * are the ones extrapolateCsvData computes, so loading the file needs no parsing and no pass
+ * over the rows. All the values are in the byte order of the machine that wrote the file.
+ */
+struct MarketDataHeader
+{
+    char magic[8];         /**< MARKET_DATA_MAGIC */
+    uint32_t version;      /**< MARKET_DATA_VERSION */
+    uint32_t reserved;     /**< Zero */
+    uint64_t num_rows;     /**< Number of days */
+    double return_mean;    /**< Mean of the daily log returns */
+    double return_std_dev; /**< Standard deviation of the daily log returns */
+    double last_close;     /**< Close price of the last day */
+};
+
+  /**
+ * @brief Get the offset of a column of a market data file.
+ * @param column The index of the column: 0 dates, 1 open prices, 2 close prices, 3 log returns.
+ * @param num_rows The number of days.
+ * @return The offset in bytes.
+ */
+size_t marketDataColumnOffset(size_t column, size_t num_rows);
+
+  /**
+ * @brief Calculate the mean and the standard deviation of the daily log returns of an asset.
+ * @details The returns are added one by one to a RunningStatistics, as extrapolateCsvData does
+ * while it parses them, so both give the same bits. The standard deviation is the population
+ * one, divided by the number of days.
+ * @param daily_returns The daily log returns.
+ * @param return_mean The mean of the returns.
+ * @param return_std_dev The standard deviation of the returns.
+ */
+void calculateReturnStatistics(const std::vector<double> &daily_returns, double &return_mean, double &return_std_dev);
+
+  /**
+ * @brief Move a cursor in a CSV file to the start of the next line.
+ * @param cursor The cursor, moved after the next line feed or to the end of the file.
+ * @param end The end of the file.
+ */
+void skipCsvLine(const char *&cursor, const char *end);
+
+  /**
+ * @brief Parse the line of a CSV file of daily prices at a cursor.
+ * @details The line has the columns Date,Open,High,Low,Close,... The date is returned as it
+ * is, the open and close prices are parsed with std::from_chars straight from the bytes. The
+ * close price may be the last field of the line, ended by a line feed, a carriage return or
+ * the end of the file. extrapolateCsvData and convertCsvToMarketData both use this parser,
+ * so a market data file holds the prices the CSV file is loaded with.
+ * @param cursor The start of a non-empty line, moved to the start of the next line on success.
+ * @param end The end of the file.
+ * @param date The date field.
+ * @param open_price The open price.
+ * @param close_price The close price.
+ * @return True if the prices have been parsed, false if the line is invalid.
+ */
+bool parseCsvPriceLine(const char *&cursor, const char *end, std::string_view &date, double &open_price, double &close_price);
+
+  /**
+ * @brief Convert a CSV file of daily prices to a market data file.
+ * @details The CSV file has the columns Date,Open,High,Low,Close,... of extrapolateCsvData,
+ * with the dates in the yyyy-mm-dd format, and is parsed by parseCsvPriceLine.
+ * @param csv_filename The name of the CSV file.
+ * @param filename The name of the market data file, replaced if it exists.
+ * @return A MarketDataError value that indicates the status of the function.
+ */
+MarketDataError convertCsvToMarketData(const std::string &csv_filename, const std::string &filename);
+
+  /**
+ * @brief Load an asset from a market data file.
+ * @details The file is memory-mapped, the statistics are read from the header and the
+ * log returns are copied from their column.
+ * @param filename The name of the market data file.
+ * @param asset_ptr The pointer to the Asset object.
+ * @return A MarketDataError value that indicates the status of the function.
+ */
+MarketDataError loadMarketData(const std::string &filename, Asset *asset_ptr);
+
+#endif
@@ -0,0 +1,219 @@
+/**
+ * @file finance_matrix.hpp
+ * @brief This file contains the declarations of the Matrix and PackedLowerMatrix classes and of their products.
+ */
+
+#ifndef PROJECT_FINANCEMATRIX_HPP
+    #define PROJECT_FINANCEMATRIX_HPP
+
+#include <memory>
+#include <cstddef>
+#include <cstdlib>
+
+  /**
+ * @brief The alignment in bytes of the storage and of the rows of the matrices, one cache line
+ */
+constexpr size_t MATRIX_ALIGNMENT = 64;
+
+  /**
+ * @class Matrix
+ * @brief A dense row-major matrix of doubles in one aligned allocation.
+ *
+ * The rows are stored one after the other, leadingDimension() values apart:
+ * the leading dimension is the number of columns rounded up to a whole number
+ * of cache lines, so every row starts on a MATRIX_ALIGNMENT boundary and the
+ * inner loops over a row run on aligned, contiguous SIMD lanes. When the rows
+ * would be a multiple of 4 KiB apart, which would put the same column of
+ * consecutive rows in the same sets of the L1 cache, one more cache line is
+ * added. The padding is zero and is not part of the matrix.
+ */
+class Matrix
+{
+public:
+    Matrix() = default;
+
+    /**
+     * @brief Construct a matrix of zeros
+     * @param rows The number of rows
+     * @param columns The number of columns
+     * @param column_multiple The leading dimension is also rounded up to a multiple of it,
+     * for kernels that read whole blocks of columns past the last one
+     */
+    Matrix(size_t rows, size_t columns, size_t column_multiple = 1);
+
+    Matrix(const Matrix &other);
+    Matrix &operator=(const Matrix &other);
+    Matrix(Matrix &&other) noexcept            = default;
+    Matrix &operator=(Matrix &&other) noexcept = default;
+
+    /**
+     * @brief Get the number of rows
+     * @return The number of rows
+     */
+    inline size_t rows() const { return num_rows; }
+
+    /**
+     * @brief Get the number of columns
+     * @return The number of columns, without the padding
+     */
+    inline size_t columns() const { return num_columns; }
+
+    /**
+     * @brief Get the distance between two consecutive rows
+     * @return The number of values from the start of a row to the start of the next one
+     */
+    inline size_t leadingDimension() const { return leading_dimension; }
+
+    /**
+     * @brief Check if the matrix has no entries
+     * @return True if the matrix has no rows or no columns
+     */
+    inline bool empty() const { return num_rows == 0 || num_columns == 0; }
+
+    /**
+     * @brief Get a row
+     * @param i The index of the row
+     * @return The pointer to the first value of the row, aligned to MATRIX_ALIGNMENT
+     */
+    inline double *row(size_t i) { return values.get() + i * leading_dimension; }
+    inline const double *row(size_t i) const { return values.get() + i * leading_dimension; }
+
+    /**
+     * @brief Get an entry
+     * @param i The index of the row
+     * @param j The index of the column
+     * @return The reference to the entry
+     */
+    inline double &operator()(size_t i, size_t j) { return values[i * leading_dimension + j]; }
+    inline double operator()(size_t i, size_t j) const { return values[i * leading_dimension + j]; }
+
+    /**
+     * @brief Get the storage, rows() * leadingDimension() values
+     * @return The pointer to the first value, nullptr if the matrix is empty
+     */
+    inline double *data() { return values.get(); }
+    inline const double *data() const { return values.get(); }
+
+private:
+    struct FreeDeleter
+    {
+        void operator()(double *pointer) const { std::free(pointer); }
+    };
+
+    size_t num_rows          = 0;
+    size_t num_columns       = 0;
+    size_t leading_dimension = 0;
+    std::unique_ptr<double[], FreeDeleter> values;
+};
+
+  /**
+ * @class PackedLowerMatrix
+ * @brief A lower-triangular square matrix of doubles packed row by row.
+ *
+ * The row i holds the entries (i, 0) to (i, i) and starts i * (i + 1) / 2
+ * values after the first one, so the triangle takes half the memory of a
+ * Matrix and the rows are read as contiguous streams by the triangular
+ * products. The storage starts on a MATRIX_ALIGNMENT boundary.
+ */
+class PackedLowerMatrix
+{
+public:
+    PackedLowerMatrix() = default;
+
+    /**
+     * @brief Construct a lower-triangular matrix of zeros
+     * @param size The number of rows and of columns
+     */
+    explicit PackedLowerMatrix(size_t size);
+
+    /**
+     * @brief Construct a packed copy of the lower triangle of a square matrix
+     * @param lower The square matrix, its upper triangle is ignored
+     * @param scale The factor applied to every entry
+     */
+    explicit PackedLowerMatrix(const Matrix &lower, double scale = 1.0);
+
+    PackedLowerMatrix(const PackedLowerMatrix &other);
+    PackedLowerMatrix &operator=(const PackedLowerMatrix &other);
+    PackedLowerMatrix(PackedLowerMatrix &&other) noexcept            = default;
+    PackedLowerMatrix &operator=(PackedLowerMatrix &&other) noexcept = default;
+
+    /**
+     * @brief Get the number of rows and of columns
+     * @return The size of the matrix
+     */
+    inline size_t size() const { return num_rows; }
+
+    /**
+     * @brief Get a row of the triangle
+     * @param i The index of the row
+     * @return The pointer to the entry (i, 0), followed by the entries up to (i, i)
+     */
+    inline double *row(size_t i) { return values.get() + i * (i + 1) / 2; }
+    inline const double *row(size_t i) const { return values.get() + i * (i + 1) / 2; }
+
+    /**
+     * @brief Get an entry of the triangle
+     * @param i The index of the row
+     * @param j The index of the column, not greater than i
+     * @return The reference to the entry
+     */
+    inline double &operator()(size_t i, size_t j) { return row(i)[j]; }
+    inline double operator()(size_t i, size_t j) const { return row(i)[j]; }
+
+private:
+    struct FreeDeleter
+    {
+        void operator()(double *pointer) const { std::free(pointer); }
+    };
+
+    size_t num_rows = 0;
+    std::unique_ptr<double[], FreeDeleter> values;
+};
+
+  /**
+ * @brief Compute the product y = A x of a matrix and a vector.
+ * @param A The matrix.
+ * @param x The vector, A.columns() values.
+ * @param y The vector to store the product, A.rows() values, not overlapping x.
+ */
+void matrixVectorProduct(const Matrix &A, const double *x, double *y);
+
+  /**
+ * @brief Compute the product y = L x of the lower triangle of a square matrix and a vector.
+ * @details Every entry is the dot product of the row i of L up to the diagonal with x.
+ * @param L The square matrix, its upper triangle is ignored.
+ * @param x The vector, L.rows() values.
+ * @param y The vector to store the product, L.rows() values, not overlapping x.
+ */
+void lowerMatrixVectorProduct(const Matrix &L, const double *x, double *y);
+
+  /**
+ * @brief Compute the product y = L^T x of the transpose of the lower triangle of a square matrix and a vector.
+ * @details The product is accumulated row by row of L, y += x_i L(i, 0..i), so the
+ * rows are read contiguously instead of the columns.
+ * @param L The square matrix, its upper triangle is ignored.
+ * @param x The vector, L.rows() values.
+ * @param y The vector to store the product, L.rows() values, not overlapping x.
+ */
+void lowerTransposeVectorProduct(const Matrix &L, const double *x, double *y);
+
+  /**
+ * @brief Solve L x = b by forward substitution, with L the lower triangle of a square matrix.
+ * @param L The square matrix, with a non-zero diagonal, its upper triangle is ignored.
+ * @param b The right-hand side, L.rows() values.
+ * @param x The vector to store the solution, L.rows() values, it may be b.
+ */
+void lowerSolve(const Matrix &L, const double *b, double *x);
+
+  /**
+ * @brief Solve L^T x = b by back substitution, with L the lower triangle of a square matrix.
+ * @details Once x_i is known, it is removed from the right-hand side of the rows above it
+ * with the row i of L, so the rows are read contiguously instead of the columns.
+ * @param L The square matrix, with a non-zero diagonal, its upper triangle is ignored.
+ * @param b The right-hand side, L.rows() values.
+ * @param x The vector to store the solution, L.rows() values, it may be b.
+ */
+void lowerTransposeSolve(const Matrix &L, const double *b, double *x);
+
+#endif
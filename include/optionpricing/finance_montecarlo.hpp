@@ -12,49 +12,555 @@
 #include <vector>
 #include <string>
 #include <random>
+#include <memory>
+#include <limits>
+#include <algorithm>
 
 #include "finance_inputmanager.hpp"
 #include "../integration/geometry/hyperrectangle.hpp"
 #include "asset.hpp"
 #include "finance_enums.hpp"
 #include "../../include/optionpricing/finance_montecarloutils.hpp"
+#include "../integration/runningstatistics.hpp"
+#include "../integration/vectormath.hpp"
+#include "../integration/qmcsequence.hpp"
+#include "finance_shocks.hpp"
+#include "finance_bridge.hpp"
+
+  /**
+ * @brief The number of antithetic pairs of paths advanced together by the path kernel
+ */
+constexpr size_t PATHS_PER_BLOCK = 64;
+
+  /**
+ * @brief The number of time steps whose shocks are generated together
+ */
+constexpr size_t STEPS_PER_TILE = 16;
+
+  /**
+ * @brief The number of contracts of a book whose payoffs are evaluated together on a block of pairs
+ */
+constexpr size_t BOOK_CONTRACTS_PER_TILE = 64;
+
+  /**
+ * @brief The number of antithetic pairs of every pilot run of the importance sampling
+ */
+constexpr size_t PILOT_PAIRS = 2048;
+
+  /**
+ * @brief The maximum number of cross-entropy iterations choosing the importance sampling shift
+ */
+constexpr size_t PILOT_ITERATIONS = 8;
+
+  /**
+ * @brief The fraction of the pilot paths above the intermediate levels of the cross-entropy method
+ */
+constexpr double PILOT_ELITE_FRACTION = 0.1;
+
+  /**
+ * @struct OptionContract
+ * @brief A contract of an option book, on the basket of all the assets.
+ */
+struct OptionContract
+{
+    double strike_price;    /**< Strike price of the contract */
+    OptionType option_type; /**< European (final basket) or Asian (basket of the averages over the days) */
+    PayoffType payoff_type; /**< Call or put */
+};
+
+  /**
+ * @struct ContractArrays
+ * @brief The contracts of an option book in structure-of-arrays layout, for the SIMD payoff loop.
+ * @details The payoff of the contract c is max(0, signs[c] (basket - strikes[c])), the basket being
+ * final + average_weights[c] (average - final), with final and average the sums over the assets of
+ * the final prices and of the averages of the prices over the days.
+ * @tparam T The floating point type of the payoff loop, float or double.
+ */
+template <typename T>
+struct ContractArrays
+{
+    std::vector<T> strikes;         /**< Strike prices of the contracts */
+    std::vector<T> signs;           /**< 1 for the calls, -1 for the puts */
+    std::vector<T> average_weights; /**< 1 for the Asian contracts, 0 for the European ones */
+
+      /**
+     * @brief Construct the arrays from the contracts of a book.
+     * @param contracts The contracts of the book.
+     */
+    explicit ContractArrays(const std::vector<OptionContract> &contracts)
+        : strikes(contracts.size()), signs(contracts.size()), average_weights(contracts.size())
+    {
+        for (size_t c = 0; c < contracts.size(); ++c)
+        {
+            strikes[c]         = static_cast<T>(contracts[c].strike_price);
+            signs[c]           = contracts[c].payoff_type == PayoffType::Put ? T(-1) : T(1);
+            average_weights[c] = contracts[c].option_type == OptionType::Asian ? T(1) : T(0);
+        }
+    }
+};
+
+  /**
+ * @struct BookBlockState
+ * @brief The baskets and the samples of a block of antithetic pairs priced against all the contracts of a book.
+ * @tparam T The floating point type of the baskets and of the payoff loop, float or double.
+ */
+template <typename T>
+struct BookBlockState
+{
+    alignas(64) T final1[PATHS_PER_BLOCK];   /**< Final baskets of the paths */
+    alignas(64) T final2[PATHS_PER_BLOCK];   /**< Final baskets of the antithetic paths */
+    alignas(64) T average1[PATHS_PER_BLOCK]; /**< Baskets of the averages over the days of the paths */
+    alignas(64) T average2[PATHS_PER_BLOCK]; /**< Baskets of the averages over the days of the antithetic paths */
+    std::vector<double> samples;             /**< Samples of the pairs for a tile of contracts, the ones of the pair p from p * BOOK_CONTRACTS_PER_TILE */
+    std::vector<double> means;               /**< Means of the samples of the contracts over the block */
+    std::vector<double> squares;             /**< Sums of the squared deviations of the samples of the contracts from their means */
+};
+
+  /**
+ * @brief Clear the baskets of a block.
+ * @tparam T The floating point type of the baskets, float or double.
+ * @param state The state of the block.
+ */
+template <typename T>
+void resetBookBlock(BookBlockState<T> &state)
+{
+    std::fill(state.final1, state.final1 + PATHS_PER_BLOCK, T(0));
+    std::fill(state.final2, state.final2 + PATHS_PER_BLOCK, T(0));
+    std::fill(state.average1, state.average1 + PATHS_PER_BLOCK, T(0));
+    std::fill(state.average2, state.average2 + PATHS_PER_BLOCK, T(0));
+}
+
+  /**
+ * @brief Add the prices of one asset to the baskets of a block.
+ * @tparam T The floating point type of the baskets, float or double.
+ * @param state The state of the block.
+ * @param final1 The final prices of the paths.
+ * @param final2 The final prices of the antithetic paths.
+ * @param sum1 The sums over the days of the prices of the paths.
+ * @param sum2 The sums over the days of the prices of the antithetic paths.
+ * @param count The number of pairs, at most PATHS_PER_BLOCK.
+ * @param average_scale The factor turning the sums into averages, 1 if they already are.
+ */
+template <typename T>
+void addToBookBlock(BookBlockState<T> &state,
+                    const T *final1,
+                    const T *final2,
+                    const T *sum1,
+                    const T *sum2,
+                    size_t count,
+                    T average_scale)
+{
+#pragma omp simd
+    for (size_t p = 0; p < count; ++p)
+    {
+        state.final1[p]   += final1[p];
+        state.final2[p]   += final2[p];
+        state.average1[p] += sum1[p] * average_scale;
+        state.average2[p] += sum2[p] * average_scale;
+    }
+}
+
+  /**
+ * @brief Price all the contracts of a book on the baskets of a block and merge the samples into their statistics.
+ * @details For every pair, the payoffs of all the contracts are evaluated in one SIMD loop over
+ * the contracts; the sample of a pair is scale times the sum of the payoffs of its two paths.
+ * The mean and the variance of the block are then computed with two passes over the samples,
+ * so the variance of a deep in the money contract does not cancel against its squared mean.
+ * @tparam T The floating point type of the payoff loop, float or double.
+ * @param state The state of the block, with its baskets.
+ * @param contracts The contracts of the book.
+ * @param count The number of pairs, at most PATHS_PER_BLOCK.
+ * @param scale Half the discount factor.
+ * @param statistics The running statistics of the contracts, one per contract.
+ */
+template <typename T>
+void priceBookBlock(BookBlockState<T> &state,
+                    const ContractArrays<T> &contracts,
+                    size_t count,
+                    T scale,
+                    std::vector<RunningStatistics> &statistics)
+{
+    size_t num_contracts     = contracts.strikes.size();
+    const T *strikes         = contracts.strikes.data();
+    const T *signs           = contracts.signs.data();
+    const T *average_weights = contracts.average_weights.data();
+
+    state.samples.resize(PATHS_PER_BLOCK * BOOK_CONTRACTS_PER_TILE);
+    state.means.resize(num_contracts);
+    state.squares.resize(num_contracts);
+    double inverse_count = 1.0 / static_cast<double>(count);
+
+      // The contracts are priced in tiles, so the samples of a tile stay in the L1 cache
+      // between the two passes
+    for (size_t c0 = 0; c0 < num_contracts; c0 += BOOK_CONTRACTS_PER_TILE)
+    {
+        size_t tile     = std::min(BOOK_CONTRACTS_PER_TILE, num_contracts - c0);
+        double *means   = state.means.data() + c0;
+        double *squares = state.squares.data() + c0;
+        std::fill(means, means + tile, 0.0);
+        std::fill(squares, squares + tile, 0.0);
+
+          // Samples of the pairs and their sums
+        for (size_t p = 0; p < count; ++p)
+        {
+            T basket1 = state.final1[p], spread1 = state.average1[p] - state.final1[p];
+            T basket2 = state.final2[p], spread2 = state.average2[p] - state.final2[p];
+            double *sample = state.samples.data() + p * BOOK_CONTRACTS_PER_TILE;
+#pragma omp simd
+            for (size_t c = 0; c < tile; ++c)
+            {
+                T value1  = signs[c0 + c] * (basket1 + average_weights[c0 + c] * spread1 - strikes[c0 + c]);
+                T value2  = signs[c0 + c] * (basket2 + average_weights[c0 + c] * spread2 - strikes[c0 + c]);
+                sample[c] = static_cast<double>((std::max(T(0), value1) + std::max(T(0), value2)) * scale);
+                means[c] += sample[c];
+            }
+        }
+
+#pragma omp simd
+        for (size_t c = 0; c < tile; ++c)
+            means[c] *= inverse_count;
+
+          // Squared deviations from the means
+        for (size_t p = 0; p < count; ++p)
+        {
+            const double *sample = state.samples.data() + p * BOOK_CONTRACTS_PER_TILE;
+#pragma omp simd
+            for (size_t c = 0; c < tile; ++c)
+                squares[c] += (sample[c] - means[c]) * (sample[c] - means[c]);
+        }
+    }
+
+      // Merge the moments of the block, the antithetic pair is one sample
+    for (size_t c = 0; c < num_contracts; ++c)
+        statistics[c].merge(RunningStatistics::fromMoments(count, state.means[c], state.squares[c] * inverse_count));
+}
+
+  /**
+ * @struct GreekStatistics
+ * @brief Running statistics of the sensitivities of the price, one sample per antithetic pair.
+ */
+struct GreekStatistics
+{
+    std::vector<RunningStatistics> delta; /**< Derivatives with respect to the initial price of every asset */
+    std::vector<RunningStatistics> gamma; /**< Second derivatives with respect to the initial price of every asset */
+    RunningStatistics vega;               /**< Derivative with respect to a common shift of the volatilities of the assets */
+    RunningStatistics rho;                /**< Derivative with respect to the interest rate */
+};
 
   /**
  * @brief Predict the price of an option using the Monte Carlo method.
  * @details This function predicts the price of an option using the Monte Carlo method.
+ * The paths are simulated in blocks of PATHS_PER_BLOCK antithetic pairs. Every block draws
+ * fresh correlated shocks from its own RandomStream (seed, block), so the result only
+ * depends on the seed and on the number of points.
+ * With the Brownian bridge construction, the paths of all the assets are built from one
+ * point of a Sobol sequence of dimension num_assets * num_steps, scrambled with the seed;
+ * the first coordinates set the final prices of all the assets, the next ones the
+ * midpoints of the bridges. A call is then one randomization of the sequence, and only
+ * its mean is added to the statistics, as one independent sample, so the standard
+ * error comes from the spread between calls with different seeds.
+ * With the control variate, every pair also gives a control with a known expectation:
+ * the call on the geometric basket of the time averages, weighted by the initial prices
+ * (lognormal, priced in closed form) for the Asian options, the discounted final basket for the European
+ * ones. The optimal coefficient is estimated from the pairs of the call.
+ * With the importance sampling, the independent normals driving the paths are shifted
+ * by a constant vector mu, one component per factor of the Cholesky decomposition, and
+ * the payoffs are weighted by the likelihood ratio exp(-mu . sum_s z_s - n |mu|^2 / 2)
+ * (the antithetic paths mirror the normals around mu). The shift is chosen by the
+ * cross-entropy method on short pilot runs, through intermediate strikes when the
+ * strike is far out of the money, so more paths end in the exercise region. The pilot
+ * only runs when importance_shift is empty, so the calls of a pricing run share its shift.
+ * With the Greeks, the same pass gives one more sample per pair of every sensitivity:
+ * delta, vega and rho with the pathwise derivatives of the payoff, which are the
+ * derivatives of the basket in the exercise region, and gamma with the mixed estimator,
+ * the pathwise delta times the likelihood ratio score of the first step of the paths.
+ * The Greeks are the ones of the plain payoff, the control variate only applies to the price.
  * @param points The number of points to use in the Monte Carlo method.
- * @param function The function to use in the Monte Carlo method.
  * @param assetPtrs The vector of pointers to the Asset objects.
- * @param variance The variance of the Monte Carlo method.
- * @param coefficients The coefficients of the function.
+ * @param A The lower Cholesky factor of the covariance matrix of the daily returns of the
+ * assets, in their order, e.g. the one of factorizeCovarianceMatrix.
+ * @param statistics The running statistics of the samples, every sample being the discounted
+ * payoff averaged over an antithetic pair; the statistics of the call are merged into it.
+ * With the Brownian bridge construction, the sample is the mean of the call.
  * @param strike_price The strike price of the option.
  * @param predicted_assets_prices The vector that will contain the predicted assets prices.
+ * @param option_type The type of the option.
+ * @param precision The floating point precision of the path kernel.
+ * @param construction The construction of the paths.
+ * @param variance_reduction The variance reduction technique applied on top of the antithetic pairs.
+ * @param importance_shift The shift mu of the importance sampling, one component per asset: chosen
+ * by the pilot runs and stored if empty, used as it is otherwise; unused by the other techniques.
+ * @param variance_ratio The variance of the plain samples divided by the variance of the
+ * samples after the variance reduction, 1 without it.
+ * @param greeks The running statistics of the Greeks, merged like the ones of the price,
+ * nullptr to skip them; delta and gamma are resized to the number of assets if empty.
+ * @param seed The seed of the random streams, different calls must use different seeds.
+ * @param error The error of the Monte Carlo method.
  * @return A pair containing the price of the option and the computation time in microseconds.
  */
 std::pair<double, double> monteCarloPricePrediction(size_t points,
                                                     const std::vector<const Asset *> &assetPtrs,
-                                                    double &variance,
+                                                    const Matrix &A,
+                                                    RunningStatistics &statistics,
                                                     const double strike_price,
                                                     std::vector<double> &predicted_assets_prices,
                                                     const OptionType &option_type,
+                                                    const PathPrecision &precision,
+                                                    const PathConstruction &construction,
+                                                    const VarianceReduction &variance_reduction,
+                                                    std::vector<double> &importance_shift,
+                                                    double &variance_ratio,
+                                                    GreekStatistics *greeks,
+                                                    uint64_t seed,
                                                     MonteCarloError &error);
 
   /**
- * @brief Generate a random point for the Monte Carlo simulation.
- * @details This function generates a random point for the Monte Carlo simulation.
- * @param random_point1 Vector to store the first random point.
- * @param random_point2 Vector to store the second random point.
- * @param assetPtrs Vector of pointers to the Asset objects.
- * @param predicted_assets_prices Vector to store the predicted asset prices.
+ * @brief Price a book of options on the same simulated paths.
+ * @details The antithetic pairs of paths are simulated once, block by block as in
+ * monteCarloPricePrediction, over 252 days if any contract is Asian and in one step
+ * otherwise; the final prices of the daily paths are exact samples of the prices in one
+ * year, so the European contracts use them too. For every pair, the payoffs of all the
+ * contracts are evaluated in one SIMD loop over the contracts, stored in structure-of-arrays
+ * layout, and summed per contract; the block sums are merged into the statistics. The cost
+ * of a contract is a few operations per pair, against the hundreds of steps of the paths.
+ * @param points The number of points to use in the Monte Carlo method.
+ * @param assetPtrs The vector of pointers to the Asset objects.
+ * @param A The lower Cholesky factor of the covariance matrix of the daily returns of the
+ * assets, in their order, e.g. the one of factorizeCovarianceMatrix.
+ * @param contracts The contracts of the book.
+ * @param statistics The running statistics of the contracts, one per contract, every sample
+ * being the discounted payoff averaged over an antithetic pair; resized if needed.
+ * @param precision The floating point precision of the path kernel.
+ * @param seed The seed of the random streams, different calls must use different seeds.
+ * @param error The error of the Monte Carlo method.
+ * @return The computation time in microseconds.
+ */
+double monteCarloBookPricePrediction(size_t points,
+                                     const std::vector<const Asset *> &assetPtrs,
+                                     const Matrix &A,
+                                     const std::vector<OptionContract> &contracts,
+                                     std::vector<RunningStatistics> &statistics,
+                                     const PathPrecision &precision,
+                                     uint64_t seed,
+                                     MonteCarloError &error);
+
+  /**
+ * @brief Running state of a block of antithetic pairs of geometric Brownian motion paths of one asset.
+ * @details Only the current prices and, for the Asian options, the running sums are kept.
+ * @tparam T The floating point type of the kernel, float or double.
+ */
+template <typename T>
+struct PathBlockState
+{
+    alignas(64) T price1[PATHS_PER_BLOCK];       /**< Current prices of the paths */
+    alignas(64) T price2[PATHS_PER_BLOCK];       /**< Current prices of the antithetic paths */
+    alignas(64) T sum1[PATHS_PER_BLOCK];         /**< Running sums of the prices of the paths */
+    alignas(64) T sum2[PATHS_PER_BLOCK];         /**< Running sums of the prices of the antithetic paths */
+    alignas(64) T level[PATHS_PER_BLOCK];        /**< Sums of the diffusion increments, opposite for the antithetic paths */
+    alignas(64) T level_sum[PATHS_PER_BLOCK];    /**< Running sums of the levels, for the geometric average */
+    alignas(64) T coarse_sum1[PATHS_PER_BLOCK];  /**< Running sums of the prices of the paths at the even steps */
+    alignas(64) T coarse_sum2[PATHS_PER_BLOCK];  /**< Running sums of the prices of the antithetic paths at the even steps */
+    alignas(64) T level_price1[PATHS_PER_BLOCK]; /**< Running sums of the prices of the paths times their levels */
+    alignas(64) T level_price2[PATHS_PER_BLOCK]; /**< Running sums of the prices of the antithetic paths times their levels */
+    alignas(64) T time_price1[PATHS_PER_BLOCK];  /**< Running sums of the prices of the paths times their steps */
+    alignas(64) T time_price2[PATHS_PER_BLOCK];  /**< Running sums of the prices of the antithetic paths times their steps */
+};
+
+  /**
+ * @brief Start a block of paths from the initial price of the asset.
+ * @tparam T The floating point type of the kernel, float or double.
+ * @param state The state of the block.
+ * @param initial_price The price of the asset at time 0.
+ */
+template <typename T>
+void resetPathBlock(PathBlockState<T> &state, T initial_price)
+{
+    for (size_t p = 0; p < PATHS_PER_BLOCK; ++p)
+    {
+        state.price1[p]       = initial_price;
+        state.price2[p]       = initial_price;
+        state.sum1[p]         = 0;
+        state.sum2[p]         = 0;
+        state.level[p]        = 0;
+        state.level_sum[p]    = 0;
+        state.coarse_sum1[p]  = 0;
+        state.coarse_sum2[p]  = 0;
+        state.level_price1[p] = 0;
+        state.level_price2[p] = 0;
+        state.time_price1[p]  = 0;
+        state.time_price2[p]  = 0;
+    }
+}
+
+  /**
+ * @brief Advance a block of antithetic geometric Brownian motion paths of one asset.
+ * @details The paths are advanced together in structure-of-arrays layout, one SIMD loop
+ * per time step. The antithetic path reuses the exponential of its twin,
+ * exp(drift - z) = exp(2 drift) / exp(drift + z), so every step costs one exponential
+ * per pair. The sums of the diffusion increments are kept as well: they give the logarithm
+ * of the prices, and so the geometric average, without any logarithm.
+ * @tparam T The floating point type of the kernel, float or double.
+ * @param state The state of the block.
+ * @param increments The diffusion increments sqrt(dt) * z of the paths, the increment of the
+ * step s of the path p is increments[s * PATHS_PER_BLOCK + p].
+ * @param num_steps The number of time steps.
+ * @param count The number of pairs of paths, at most PATHS_PER_BLOCK.
+ * @param drift The drift of the logarithm of the price over one step, (r - sigma^2 / 2) dt.
+ */
+template <typename T>
+void advancePathBlock(PathBlockState<T> &state,
+                      const T *increments,
+                      size_t num_steps,
+                      size_t count,
+                      T drift)
+{
+    T growth = simdExp(2 * drift);
+
+    for (size_t step = 0; step < num_steps; ++step)
+    {
+        const T *z = increments + step * PATHS_PER_BLOCK;
+
+#pragma omp simd
+        for (size_t p = 0; p < count; ++p)
+        {
+            T factor = simdExp(drift + z[p]);
+            state.price1[p]    *= factor;
+            state.price2[p]    *= growth / factor;
+            state.sum1[p]      += state.price1[p];
+            state.sum2[p]      += state.price2[p];
+            state.level[p]     += z[p];
+            state.level_sum[p] += state.level[p];
+        }
+    }
+}
+
+  /**
+ * @brief Advance a block of antithetic paths of one asset and the sums needed by the Greeks.
+ * @details Same step as advancePathBlock, but the prices are also summed times the level of
+ * the path, for the derivative with respect to the volatility, and times the index of the
+ * step, for the derivatives with respect to the drift.
+ * @tparam T The floating point type of the kernel, float or double.
+ * @param state The state of the block.
+ * @param increments The diffusion increments sqrt(dt) * z of the paths, the increment of the
+ * step s of the path p is increments[s * PATHS_PER_BLOCK + p].
+ * @param first_step The index of the first step of the increments.
+ * @param num_steps The number of time steps.
+ * @param count The number of pairs of paths, at most PATHS_PER_BLOCK.
+ * @param drift The drift of the logarithm of the price over one step, (r - sigma^2 / 2) dt.
+ */
+template <typename T>
+void advanceSensitivityPathBlock(PathBlockState<T> &state,
+                                 const T *increments,
+                                 size_t first_step,
+                                 size_t num_steps,
+                                 size_t count,
+                                 T drift)
+{
+    T growth = simdExp(2 * drift);
+
+    for (size_t step = 0; step < num_steps; ++step)
+    {
+        const T *z = increments + step * PATHS_PER_BLOCK;
+        T time     = static_cast<T>(first_step + step + 1);
+
+#pragma omp simd
+        for (size_t p = 0; p < count; ++p)
+        {
+            T factor = simdExp(drift + z[p]);
+            state.price1[p]       *= factor;
+            state.price2[p]       *= growth / factor;
+            state.sum1[p]         += state.price1[p];
+            state.sum2[p]         += state.price2[p];
+            state.level[p]        += z[p];
+            state.level_sum[p]    += state.level[p];
+            state.level_price1[p] += state.level[p] * state.price1[p];
+            state.level_price2[p] -= state.level[p] * state.price2[p];
+            state.time_price1[p]  += time * state.price1[p];
+            state.time_price2[p]  += time * state.price2[p];
+        }
+    }
+}
+
+  /**
+ * @brief Advance a block of antithetic paths of one asset on the fine grid of a pair of coupled grids.
+ * @details Same step as advancePathBlock, but the prices at the even steps (counted from 1),
+ * which are the prices of the same paths on the grid with steps twice as long, are also summed.
+ * The geometric Brownian motion is sampled exactly at the points of the grid, so the coarse
+ * paths need no shocks of their own.
+ * @tparam T The floating point type of the kernel, float or double.
+ * @param state The state of the block.
+ * @param increments The diffusion increments sqrt(dt) * z of the paths, the increment of the
+ * step s of the path p is increments[s * PATHS_PER_BLOCK + p].
+ * @param first_step The index of the first step of the increments on the fine grid.
+ * @param num_steps The number of time steps.
+ * @param count The number of pairs of paths, at most PATHS_PER_BLOCK.
+ * @param drift The drift of the logarithm of the price over one fine step.
  */
-void generateRandomPoint(std::vector<double> &random_point1,
-                         std::vector<double> &random_point2,
-                         const std::vector<const Asset *> &assetPtrs,
-                         std::vector<double> &predicted_assets_prices,
-                         const OptionType &option_type,
-                         const std::vector<std::vector<double>> &A,
-                         const std::vector<std::vector<double>> &zeta_matrix,
-                         const uint num_days_to_simulate);
+template <typename T>
+void advanceCoupledPathBlock(PathBlockState<T> &state,
+                             const T *increments,
+                             size_t first_step,
+                             size_t num_steps,
+                             size_t count,
+                             T drift)
+{
+    T growth = simdExp(2 * drift);
+
+    for (size_t step = 0; step < num_steps; ++step)
+    {
+        const T *z = increments + step * PATHS_PER_BLOCK;
+        T coarse   = ((first_step + step) & 1) ? T(1) : T(0);
+
+#pragma omp simd
+        for (size_t p = 0; p < count; ++p)
+        {
+            T factor = simdExp(drift + z[p]);
+            state.price1[p]      *= factor;
+            state.price2[p]      *= growth / factor;
+            state.sum1[p]        += state.price1[p];
+            state.sum2[p]        += state.price2[p];
+            state.coarse_sum1[p] += coarse * state.price1[p];
+            state.coarse_sum2[p] += coarse * state.price2[p];
+        }
+    }
+}
+
+  /**
+ * @brief Add the values of a block of paths of one asset to the payoff baskets.
+ * @tparam T The floating point type of the kernel, float or double.
+ * @param state The state of the block after the last step.
+ * @param num_steps The total number of time steps.
+ * @param count The number of pairs of paths, at most PATHS_PER_BLOCK.
+ * @param average True to use the average price over the steps (Asian), false for the final one.
+ * @param weight The weight of the asset in the geometric basket.
+ * @param basket1 The values entering the payoff of the paths, the price of the asset is added to it.
+ * @param basket2 The values entering the payoff of the antithetic paths, the price of the asset is added to it.
+ * @param level_sum The weighted sums of the levels of the paths over the steps, the ones of the asset
+ * times its weight are added to it; the antithetic paths have the opposite sums.
+ * @return The sum of the final prices of all the paths of the block.
+ */
+template <typename T>
+double finishPathBlock(const PathBlockState<T> &state,
+                       size_t num_steps,
+                       size_t count,
+                       bool average,
+                       T weight,
+                       T *basket1,
+                       T *basket2,
+                       T *level_sum)
+{
+    T inverse_steps = T(1) / static_cast<T>(num_steps);
+    double final_sum = 0.0;
+
+    for (size_t p = 0; p < count; ++p)
+    {
+        basket1[p]   += average ? state.sum1[p] * inverse_steps : state.price1[p];
+        basket2[p]   += average ? state.sum2[p] * inverse_steps : state.price2[p];
+        level_sum[p] += weight * state.level_sum[p];
+        final_sum    += static_cast<double>(state.price1[p]) + static_cast<double>(state.price2[p]);
+    }
 
+    return final_sum;
+}
 
 #endif
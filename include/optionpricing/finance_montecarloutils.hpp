@@ -12,20 +12,56 @@
 #include <vector>
 #include <string>
 #include <random>
+#include <memory>
+#include <cstdlib>
+#include <algorithm>
 
 #include "asset.hpp"
 #include "finance_enums.hpp"
 #include "finance_inputmanager.hpp"
+#include "finance_matrix.hpp"
 #include "../integration/geometry/hyperrectangle.hpp"
 
+  /**
+ * @brief The number of assets of the square tiles of the covariance matrix, the unit of work of the threads
+ */
+constexpr size_t COVARIANCE_TILE = 64;
+
+  /**
+ * @brief The number of rows of the covariance matrix computed together by the micro kernel
+ */
+constexpr size_t COVARIANCE_MICRO_ROWS = 4;
+
+  /**
+ * @brief The number of columns of the covariance matrix computed together by the micro kernel, in SIMD lanes
+ */
+constexpr size_t COVARIANCE_MICRO_COLUMNS = 32;
+
+  /**
+ * @brief The number of days processed together by the micro kernel
+ */
+constexpr size_t COVARIANCE_ROW_CHUNK = 128;
+
+static_assert(COVARIANCE_TILE % COVARIANCE_MICRO_ROWS == 0 && COVARIANCE_TILE % COVARIANCE_MICRO_COLUMNS == 0,
+              "The micro tiles must not cross the tiles of the covariance matrix");
+
+  /**
+ * @brief The number of columns of the panels of the blocked Cholesky factorization
+ */
+constexpr size_t CHOLESKY_BLOCK = 64;
 
   /**
- * @brief XOR shift random number generator.
- * @details This function generates a random number using the XOR shift algorithm.
- * @param seed The seed for the random number generator.
- * @return A random number.
+ * @brief The number of rows solved together against the diagonal block of a panel of the Cholesky factorization
  */
-uint32_t xorshift(uint32_t seed);
+constexpr size_t CHOLESKY_PANEL_ROWS = 16;
+
+  /**
+ * @brief The smallest pivot of the Cholesky factorization, relative to the diagonal entry of its row
+ */
+constexpr double CHOLESKY_PIVOT_TOLERANCE = 1e-10;
+
+static_assert(CHOLESKY_BLOCK % COVARIANCE_MICRO_COLUMNS == 0,
+              "The trailing updates of the Cholesky factorization must start on a micro tile boundary");
 
   /**
  * @brief Calculate the covariance between two assets.
@@ -38,36 +74,51 @@ double calculateCovariance(const Asset &asset1, const Asset &asset2, CovarianceE
 
   /**
  * @brief Calculate the covariance matrix for a set of assets.
- * @details This function calculates the covariance matrix for a set of assets.
+ * @details The daily returns minus their means are packed once in a T x N Matrix X, with
+ * the rows padded to a multiple of COVARIANCE_MICRO_COLUMNS, and the covariance is
+ * X^T X / (T - 1), as in calculateCovariance. Only the lower triangle is computed, like a
+ * SYRK: the threads share the COVARIANCE_TILE x COVARIANCE_TILE tiles of the lower
+ * triangle, and every tile is computed by micro tiles of COVARIANCE_MICRO_ROWS x
+ * COVARIANCE_MICRO_COLUMNS entries kept in registers over chunks of COVARIANCE_ROW_CHUNK days,
+ * with SIMD lanes over the columns. The upper triangle is mirrored. The error is Failure if the
+ * assets have different numbers of returns or less than two.
  * @param assetPtrs Vector of pointers to the Asset objects.
  * @return The covariance matrix.
  */
-std::vector<std::vector<double>> calculateCovarianceMatrix(const std::vector<const Asset *> &assetPtrs, CovarianceError &error);
+Matrix calculateCovarianceMatrix(const std::vector<const Asset *> &assetPtrs, CovarianceError &error);
 
   /**
  * @brief Perform Cholesky factorization on a matrix.
- * @details This function performs Cholesky factorization on a matrix.
- * @param A The matrix to factorize.
- * @param step_size The step size for the factorization.
- * @return The lower triangular matrix resulting from the factorization.
- */
-std::vector<std::vector<double>> choleskyFactorization(const std::vector<std::vector<double>> &A, double step_size);
-
-  /**
- * @brief Fill a matrix with random values from a normal distribution.
- * @details This function fills a matrix with random values from a normal distribution.
- * @param zeta_matrix The matrix to fill.
+ * @details Blocked right-looking factorization A = L L^T, in the storage of A. For every
+ * panel of CHOLESKY_BLOCK columns, the diagonal block is factorized row by row, the rows
+ * below it are solved against it in parallel, and the trailing lower triangle is updated
+ * with the product of the panel by its transpose. The panel is packed transposed and the
+ * update runs on the micro kernel of calculateCovarianceMatrix, with the threads sharing the
+ * COVARIANCE_TILE x COVARIANCE_TILE tiles of the trailing triangle.
+ * A pivot below CHOLESKY_PIVOT_TOLERANCE times the diagonal entry of its row, which happens
+ * when the matrix is singular or near-singular, e.g. with more assets than days of returns,
+ * is raised to that value and the rest of its column is set to zero, instead of stopping
+ * the factorization: what is left of the column is bounded by the small pivot, so L L^T is A
+ * plus a small diagonal with the correlations moved by at most sqrt(CHOLESKY_PIVOT_TOLERANCE),
+ * and the error is Regularized.
+ * @param A The symmetric matrix to factorize, only its lower triangle is read.
+ * @param error Success, Regularized, or Failure if A has non-finite entries or no positive
+ * diagonal entry.
+ * @return The lower triangular factor, with a zero upper triangle, or an empty matrix on failure.
  */
-void fillZetaMatrix(std::vector<std::vector<double>> &zeta_matrix);
+Matrix choleskyFactorization(Matrix A, CholeskyError &error);
 
   /**
- * @brief Perform vector-vector multiplication.
- * @details This function performs vector-vector multiplication for a specific row of the matrix.
- * @param matrix The matrix.
- * @param rowIdx The index of the row to use.
- * @param vector The vector to multiply.
- * @return The result of the multiplication.
+ * @brief Factorize the covariance matrix of the assets of a pricing run.
+ * @details Checks that the matrix is the one of the assets and calls choleskyFactorization,
+ * printing the error or the regularization warning. The pricing functions take the factor,
+ * so a run factorizes the matrix and reports its state once, before its iterations.
+ * @param covariance_matrix The covariance matrix of the daily returns of the assets, in their order.
+ * @param num_assets The number of assets.
+ * @param error Success, Regularized, or Failure if the size does not match or the matrix
+ * could not be factorized.
+ * @return The lower triangular factor, or an empty matrix on failure.
  */
-double VVMult(const std::vector<std::vector<double>> &matrix, size_t rowIdx, const std::vector<double> &vector);
+Matrix factorizeCovarianceMatrix(const Matrix &covariance_matrix, size_t num_assets, CholeskyError &error);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+/**
+ * @file finance_multilevel.hpp
+ * @brief This file contains the declarations of the multilevel Monte Carlo pricing of the Asian options.
+ */
+
+#ifndef PROJECT_FINANCEMULTILEVEL_HPP
+    #define PROJECT_FINANCEMULTILEVEL_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+
+#include "asset.hpp"
+#include "finance_enums.hpp"
+#include "finance_matrix.hpp"
+#include "finance_montecarlo.hpp"
+#include "../integration/runningstatistics.hpp"
+
+  /**
+ * @brief The number of antithetic pairs simulated on every level before the first allocation
+ */
+constexpr size_t MULTILEVEL_PILOT_PAIRS = 256;
+
+  /**
+ * @brief The maximum number of allocation rounds of the multilevel estimator
+ */
+constexpr size_t MULTILEVEL_MAX_ROUNDS = 16;
+
+  /**
+ * @struct MultilevelLevel
+ * @brief The samples of one level of the multilevel estimator.
+ */
+struct MultilevelLevel
+{
+    size_t num_steps;             /**< Number of steps of the fine grid of the level */
+    size_t step_days;             /**< Number of days of the steps of the fine grid, except the last one */
+    RunningStatistics correction; /**< Discounted payoff on the fine grid minus the one on the coarse grid, per antithetic pair */
+    RunningStatistics fine;       /**< Discounted payoff on the fine grid alone, per antithetic pair */
+};
+
+  /**
+ * @brief Get the grids of the multilevel estimator.
+ * @details The grid of the level l has its points every 2^(L - l) days, plus the last day,
+ * with L the smallest integer such that 2^L >= num_days: every grid is a subset of the
+ * next finer one and the finest grid is the daily one. For 252 days the grids have
+ * 1, 2, 4, 8, 16, 32, 63, 126 and 252 steps.
+ * @param num_days The number of days of the finest grid.
+ * @return The levels with their grids and no samples, from the coarsest grid to the finest one.
+ */
+std::vector<MultilevelLevel> multilevelGrids(size_t num_days);
+
+  /**
+ * @brief Predict the price of an Asian option with the multilevel Monte Carlo method.
+ * @details The payoff on a grid uses the average of the prices at the end of the steps,
+ * weighted by their lengths, so the finest grid gives exactly the payoff on the daily prices.
+ * The price is the telescoping sum E[P_0] + sum_l E[P_l - P_(l-1)]: the level 0 simulates
+ * one step per path, the level l simulates the fine grid of the level and reads the coarse
+ * path at the points of the grid of the level l - 1, which are points of the fine grid, so
+ * the two payoffs are strongly correlated and the corrections have a small variance. The
+ * geometric Brownian motion is sampled exactly at the points of the grids, so the estimate
+ * has no bias with respect to the price on the daily grid.
+ * After MULTILEVEL_PILOT_PAIRS pairs per level, the pairs are allocated in rounds to minimize
+ * the cost, N_l proportional to sqrt(V_l / C_l), with V_l the variance of the corrections
+ * and C_l the number of steps of the level. With a tolerance, the rounds stop when the 95%
+ * confidence interval half-width meets it; with a fixed number of points, the cost of
+ * points paths on the finest grid is spread over the levels once. The total cost is capped
+ * by the cost of max_points paths on the finest grid. Every block of pairs of every level
+ * draws its shocks from its own RandomStream (seed, level, block).
+ * @param assetPtrs The vector of pointers to the Asset objects.
+ * @param A The lower Cholesky factor of the covariance matrix of the daily returns of the
+ * assets, in their order, e.g. the one of factorizeCovarianceMatrix.
+ * @param strike_price The strike price of the option.
+ * @param precision The floating point precision of the path kernel.
+ * @param rule The stopping rule.
+ * @param tolerance The absolute or relative tolerance on the 95% confidence interval half-width.
+ * @param points The number of paths on the finest grid whose cost is spread over the levels
+ * with the fixed points rule.
+ * @param max_points The maximum cost, in paths on the finest grid.
+ * @param seed The seed of the random streams.
+ * @param levels The samples of the levels, from the coarsest to the finest one.
+ * @param standard_error The standard error of the price.
+ * @param predicted_assets_prices The vector that will contain the means of the final prices of
+ * the assets, from the paths of the level 0.
+ * @param error The error of the Monte Carlo method.
+ * @return A pair containing the price of the option and the computation time in microseconds.
+ */
+std::pair<double, double> multilevelPricePrediction(const std::vector<const Asset *> &assetPtrs,
+                                                    const Matrix &A,
+                                                    const double strike_price,
+                                                    const PathPrecision &precision,
+                                                    StoppingRule rule,
+                                                    double tolerance,
+                                                    size_t points,
+                                                    size_t max_points,
+                                                    uint64_t seed,
+                                                    std::vector<MultilevelLevel> &levels,
+                                                    double &standard_error,
+                                                    std::vector<double> &predicted_assets_prices,
+                                                    MonteCarloError &error);
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * @file finance_pathstore.hpp
+ * @brief This file contains the declarations of the binary store of simulated paths, written once and repriced many times.
+ */
+
+#ifndef PROJECT_FINANCEPATHSTORE_HPP
+    #define PROJECT_FINANCEPATHSTORE_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "asset.hpp"
+#include "finance_enums.hpp"
+#include "finance_matrix.hpp"
+#include "finance_montecarlo.hpp"
+#include "finance_mappedfile.hpp"
+#include "../integration/runningstatistics.hpp"
+
+  // Defined in finance_montecarlo.hpp, which can include this header through optionpricer.hpp
+struct OptionContract;
+
+  /**
+ * @brief The magic bytes at the start of a path store
+ */
+constexpr char PATH_STORE_MAGIC[8] = {'A', 'M', 'S', 'C', 'P', 'A', 'T', 'H'};
+
+  /**
+ * @brief The version of the format of the path stores
+ */
+constexpr uint32_t PATH_STORE_VERSION = 1;
+
+  /**
+ * @brief The maximum length of the name of an asset in a path store, including the terminating zero
+ */
+constexpr size_t PATH_STORE_NAME_LENGTH = 64;
+
+  /**
+ * @brief The alignment in bytes of the start of the columns of a path store
+ */
+constexpr size_t PATH_STORE_ALIGNMENT = 64;
+
+  /**
+ * @struct PathStoreHeader
+ * @brief The header at the start of a path store.
+ * @details The header is followed by num_assets PathStoreAsset records, by the covariance
+ * matrix of the daily returns (num_assets * num_assets doubles, row-major) and by the columns,
+ * from the first multiple of PATH_STORE_ALIGNMENT. The column of the kind k (PathColumn) of the
+ * asset i is the column k * num_assets + i; it holds num_pairs values of value_size bytes, one
+ * per antithetic pair, and is padded to a multiple of PATH_STORE_ALIGNMENT bytes. All the values
+ * are in the byte order of the machine that wrote the file.
+ */
+struct PathStoreHeader
+{
+    char magic[8];       /**< PATH_STORE_MAGIC */
+    uint32_t version;    /**< PATH_STORE_VERSION */
+    uint32_t value_size; /**< Size of the values of the columns, 4 (float) or 8 (double) */
+    uint64_t seed;       /**< Seed of the random streams of the simulation */
+    uint64_t num_pairs;  /**< Number of antithetic pairs of paths */
+    uint32_t num_assets; /**< Number of assets */
+    uint32_t num_days;   /**< Number of days of the paths */
+    double rate;         /**< Risk-free rate of the model */
+    double maturity;     /**< Maturity in years */
+};
+
+  /**
+ * @struct PathStoreAsset
+ * @brief The parameters of an asset in a path store.
+ */
+struct PathStoreAsset
+{
+    char name[PATH_STORE_NAME_LENGTH]; /**< Name of the asset, zero-terminated */
+    double initial_price;              /**< Price of the asset at time 0 */
+    double return_mean;                /**< Mean of the daily log returns */
+    double return_std_dev;             /**< Standard deviation of the daily log returns */
+};
+
+  /**
+ * @class PathStore
+ * @brief A path store mapped in memory for reading.
+ *
+ * The file is mapped with MappedFile, so opening it costs no copy and the
+ * columns are read straight from the page cache.
+ */
+class PathStore
+{
+public:
+    /**
+     * @brief Open and validate a path store
+     * @param filename The name of the file
+     * @return A PathStoreError value that indicates the status of the function
+     */
+    PathStoreError open(const std::string &filename);
+
+    /**
+     * @brief Get the header of the store
+     * @return The header
+     */
+    const PathStoreHeader &header() const { return *reinterpret_cast<const PathStoreHeader *>(file.data()); }
+
+    /**
+     * @brief Get the parameters of an asset
+     * @param asset The index of the asset
+     * @return The parameters of the asset
+     */
+    const PathStoreAsset &asset(size_t asset) const
+    {
+        return reinterpret_cast<const PathStoreAsset *>(file.data() + sizeof(PathStoreHeader))[asset];
+    }
+
+    /**
+     * @brief Get the covariance of the daily returns of two assets
+     * @param i The index of the first asset
+     * @param j The index of the second asset
+     * @return The covariance
+     */
+    double covariance(size_t i, size_t j) const;
+
+    /**
+     * @brief Get the at-the-money strike price of the basket of the assets
+     * @return The sum of the initial prices of the assets
+     */
+    double atTheMoneyStrike() const;
+
+    /**
+     * @brief Get a column of the store
+     * @tparam T The type of the values, float if value_size is 4 and double if it is 8
+     * @param kind The kind of the column
+     * @param asset The index of the asset
+     * @return The pointer to the num_pairs values of the column
+     */
+    template <typename T>
+    const T *column(PathColumn kind, size_t asset) const
+    {
+        return reinterpret_cast<const T *>(file.data() + columnOffset(kind, asset));
+    }
+
+private:
+    size_t columnOffset(PathColumn kind, size_t asset) const;
+
+    MappedFile file;
+};
+
+  /**
+ * @brief Get the offset of the first column of a path store.
+ * @param num_assets The number of assets.
+ * @return The offset in bytes.
+ */
+size_t pathStoreDataOffset(size_t num_assets);
+
+  /**
+ * @brief Get the distance between the starts of two consecutive columns of a path store.
+ * @param num_pairs The number of antithetic pairs.
+ * @param value_size The size of the values.
+ * @return The distance in bytes.
+ */
+size_t pathStoreColumnStride(size_t num_pairs, size_t value_size);
+
+  /**
+ * @brief Simulate antithetic pairs of daily paths and write them to a path store.
+ * @details The paths are the ones of monteCarloBookPricePrediction over 252 days: every block of
+ * PATHS_PER_BLOCK pairs draws its shocks from its own RandomStream (seed, block), so the same seed
+ * gives the same paths as an option book priced with the same number of points. The file is
+ * created at its final size and mapped, and every block writes the final prices and the averages
+ * over the days of its paths in place, in the precision of the kernel. With the final prices and
+ * the averages of every asset, any European or Asian payoff on the assets can be evaluated again
+ * without simulating.
+ * @param filename The name of the file, replaced if it exists.
+ * @param points The number of paths, rounded down to an even number.
+ * @param assetPtrs The vector of pointers to the Asset objects.
+ * @param covariance_matrix The covariance matrix of the daily returns of the assets, in their
+ * order, e.g. the one of the statistics store.
+ * @param precision The floating point precision of the path kernel and of the stored values.
+ * @param seed The seed of the random streams.
+ * @param error The error of the function.
+ * @return The computation time in microseconds.
+ */
+double writePathStore(const std::string &filename,
+                      size_t points,
+                      const std::vector<const Asset *> &assetPtrs,
+                      const Matrix &covariance_matrix,
+                      const PathPrecision &precision,
+                      uint64_t seed,
+                      PathStoreError &error);
+
+  /**
+ * @brief Price a book of options on the paths of a path store.
+ * @details The baskets of every block of pairs are summed from the columns of the assets and the
+ * payoffs of all the contracts are evaluated with priceBookBlock, as in
+ * monteCarloBookPricePrediction, so the prices are the same as the ones of the book priced on the
+ * simulated paths. The cost is a few operations per pair and contract, without any simulation.
+ * @param store The path store.
+ * @param contracts The contracts of the book.
+ * @param statistics The running statistics of the contracts, one per contract, every sample being
+ * the discounted payoff averaged over an antithetic pair; resized if needed.
+ * @return The computation time in microseconds.
+ */
+double repricePathStore(const PathStore &store,
+                        const std::vector<OptionContract> &contracts,
+                        std::vector<RunningStatistics> &statistics);
+
+#endif
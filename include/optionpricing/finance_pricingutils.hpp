@@ -17,6 +17,7 @@
 #include "finance_montecarlo.hpp"
 #include "optionparameters.hpp"
 #include "finance_enums.hpp"
+#include "../integration/runningstatistics.hpp"
 
 /**
  * @brief Calculates the value of the standard normal distribution function.
@@ -61,4 +62,48 @@ OptionType getOptionTypeFromUser();
  */
 AssetCountType getAssetCountTypeFromUser();
 
+/**
+ * @brief Prompts the user to select the estimator of the Asian options.
+ * @return The selected estimator.
+ */
+Estimator getEstimatorFromUser();
+
+/**
+ * @brief Prompts the user to select the source of the paths of an option book.
+ * @return The selected path source.
+ */
+PathSource getPathSourceFromUser();
+
+/**
+ * @brief Prompts the user to select the floating point precision of the path kernel.
+ * @return The selected precision.
+ */
+PathPrecision getPathPrecisionFromUser();
+
+/**
+ * @brief Prompts the user to select the construction of the paths.
+ * @return The selected path construction.
+ */
+PathConstruction getPathConstructionFromUser();
+
+/**
+ * @brief Prompts the user to select the variance reduction technique.
+ * @return The selected variance reduction.
+ */
+VarianceReduction getVarianceReductionFromUser();
+
+/**
+ * @brief Prompts the user to enter the strike as a multiple of the at-the-money strike.
+ * @return The multiple, positive.
+ */
+double getStrikeMultiplierFromUser();
+
+/**
+ * @brief Prompts the user to select the stopping rule of the Monte Carlo method.
+ * @param tolerance The absolute or relative tolerance on the 95% confidence interval half-width.
+ * @param max_simulations The maximum number of simulations with a tolerance.
+ * @return The selected stopping rule.
+ */
+StoppingRule getStoppingRuleFromUser(double &tolerance, size_t &max_simulations);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+/**
+ * @file finance_shocks.hpp
+ * @brief This file contains the declaration of the CorrelatedShocks class.
+ */
+
+#ifndef PROJECT_FINANCESHOCKS_HPP
+    #define PROJECT_FINANCESHOCKS_HPP
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#include "finance_matrix.hpp"
+#include "../integration/randomstream.hpp"
+
+  /**
+ * @brief The number of columns of the shocks processed together by the Cholesky product
+ */
+constexpr size_t SHOCK_TILE = 256;
+
+  /**
+ * @class CorrelatedShocks
+ * @brief Generator of correlated Gaussian increments for blocks of paths.
+ *
+ * For a tile of time steps of a block of paths, the generator draws fresh
+ * standard normal numbers for every asset, step and path, then applies the
+ * Cholesky factor L of the covariance matrix as one lower-triangular matrix
+ * product: the increments of the asset i are sqrt(dt) * sum_{k <= i} L(i, k) z_k,
+ * with the scaled factor kept in a PackedLowerMatrix.
+ * The product runs over SHOCK_TILE columns at a time, so the rows of the
+ * tile stay in the L1 cache while the factor is applied. The normals and
+ * the product are in the precision of the paths, so float paths get twice
+ * as many lanes per register. The generator is read-only, every thread
+ * passes its own stream and buffers.
+ * @tparam T The floating point type of the increments, float or double
+ */
+template <typename T>
+class CorrelatedShocks
+{
+public:
+    /**
+     * @brief Construct a new CorrelatedShocks object
+     * @param cholesky_factor The lower-triangular Cholesky factor of the covariance matrix of the returns
+     * @param dt The length of a time step
+     */
+    CorrelatedShocks(const Matrix &cholesky_factor, double dt);
+
+    /**
+     * @brief Generate the increments of a tile of steps of a block of paths
+     * @details The increment of the asset i, step s and path p is stored in
+     * increments[(i * num_steps + s) * paths + p].
+     * @param stream The random stream of the block of paths
+     * @param num_steps The number of steps of the tile
+     * @param paths The number of paths of the block
+     * @param normals Scratch vector, resized to num_assets * num_steps * paths
+     * @param increments Vector to store the increments, resized to num_assets * num_steps * paths
+     */
+    void generate(RandomStream &stream, size_t num_steps, size_t paths, std::vector<T> &normals, std::vector<T> &increments) const;
+
+    /**
+     * @brief Correlate given standard normal numbers of a tile of steps of a block of paths
+     * @details Same product as generate, on numbers built by the caller, e.g. by a
+     * Brownian bridge. The number of the asset i, step s and path p is
+     * normals[(i * num_steps + s) * paths + p], the layout of the increments is the same.
+     * @param num_steps The number of steps of the tile
+     * @param paths The number of paths of the block
+     * @param normals The independent standard normal numbers, num_assets * num_steps * paths long
+     * @param increments Vector to store the increments, resized to num_assets * num_steps * paths
+     */
+    void correlate(size_t num_steps, size_t paths, const std::vector<T> &normals, std::vector<T> &increments) const;
+
+    /**
+     * @brief Get the number of assets
+     * @return The number of correlated components of every shock
+     */
+    inline size_t getNumAssets() const { return num_assets; }
+
+private:
+    size_t num_assets;
+    PackedLowerMatrix factor;
+};
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ * @file finance_statisticsstore.hpp
+ * @brief This file contains the declaration of the AssetStatisticsStore class, the running statistics of the returns of the assets.
+ */
+
+#ifndef PROJECT_FINANCESTATISTICSSTORE_HPP
+    #define PROJECT_FINANCESTATISTICSSTORE_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "asset.hpp"
+#include "finance_enums.hpp"
+#include "finance_matrix.hpp"
+
+  /**
+ * @brief The name of the statistics store, written in the directory of the CSV files of the assets
+ */
+constexpr const char *STATISTICS_STORE_FILENAME = "statistics.stats";
+
+  /**
+ * @brief The magic bytes at the start of a statistics store
+ */
+constexpr char STATISTICS_STORE_MAGIC[8] = {'A', 'M', 'S', 'C', 'S', 'T', 'A', 'T'};
+
+  /**
+ * @brief The version of the format of the statistics stores
+ */
+constexpr uint32_t STATISTICS_STORE_VERSION = 2;
+
+  /**
+ * @class AssetStatisticsStore
+ * @brief Running means and co-moments of the daily log returns of a set of assets.
+ *
+ * The store keeps the number of days n, the means m_i of the returns and the
+ * co-moments C_ij = sum_t (x_i(t) - m_i) (x_j(t) - m_j) of the lower triangle,
+ * packed row by row. A new day of returns x is added with the multivariate
+ * Welford update: with d_i = x_i - m_i, m_i += d_i / (n + 1) and
+ * C_ij += d_i d_j n / (n + 1), so appending a day costs O(N^2) instead of the
+ * O(N^2 T) of the covariance of the whole history. The covariance is
+ * C_ij / (n - 1), as calculateCovarianceMatrix, and the standard deviation
+ * sqrt(C_ii / n), as calculateReturnStatistics. Every asset also keeps a
+ * fingerprint of the returns of the days of the store, a FNV-1a hash of their
+ * bits, so a history that has been edited or has moved (a rolling window) is
+ * detected and the statistics are built again instead of being extended.
+ * The store is persisted in a binary file: a header (STATISTICS_STORE_MAGIC,
+ * version, number of assets and of days), the fingerprints, the means, the
+ * packed co-moments and the names of the assets, each one after its length.
+ */
+class AssetStatisticsStore
+{
+public:
+    /**
+     * @brief Build the statistics from the whole history of the assets
+     * @details The co-moments come from calculateCovarianceMatrix, the means from the assets.
+     * @param assetPtrs The vector of pointers to the Asset objects, with the same number of returns
+     * @return A StatisticsStoreError value that indicates the status of the function
+     */
+    StatisticsStoreError build(const std::vector<const Asset *> &assetPtrs);
+
+    /**
+     * @brief Add one day of returns of all the assets
+     * @param daily_returns The returns of the day, in the order of the assets of the store
+     */
+    void addReturns(const double *daily_returns);
+
+    /**
+     * @brief Bring the statistics up to date with the returns of the assets
+     * @details The store is permuted to the order of the assets; if the assets have more
+     * returns than the days of the store, only the new days are added. The statistics are
+     * built again if the assets are not the ones of the store, have fewer returns, or if
+     * their first returns do not match the fingerprints of the days of the store.
+     * @param assetPtrs The vector of pointers to the Asset objects, with the same number of returns
+     * @param added_days The number of days added, or the number of days of the history if the
+     * statistics have been built again
+     * @param rebuilt True if the statistics have been built again
+     * @return A StatisticsStoreError value that indicates the status of the function
+     */
+    StatisticsStoreError synchronize(const std::vector<const Asset *> &assetPtrs, size_t &added_days, bool &rebuilt);
+
+    /**
+     * @brief Load the store from a file
+     * @param filename The name of the file
+     * @return A StatisticsStoreError value that indicates the status of the function
+     */
+    StatisticsStoreError load(const std::string &filename);
+
+    /**
+     * @brief Save the store to a file
+     * @param filename The name of the file, replaced if it exists
+     * @return A StatisticsStoreError value that indicates the status of the function
+     */
+    StatisticsStoreError save(const std::string &filename) const;
+
+    /**
+     * @brief Get the number of days
+     * @return The number of days of returns added so far
+     */
+    size_t getCount() const { return count; }
+
+    /**
+     * @brief Get the names of the assets
+     * @return The names, in the order of the store
+     */
+    const std::vector<std::string> &getNames() const { return names; }
+
+    /**
+     * @brief Get the mean of the returns of an asset
+     * @param i The index of the asset
+     * @return The mean
+     */
+    double getMean(size_t i) const { return means[i]; }
+
+    /**
+     * @brief Get the standard deviation of the returns of an asset
+     * @param i The index of the asset
+     * @return The population standard deviation sqrt(C_ii / n)
+     */
+    double getStdDev(size_t i) const;
+
+    /**
+     * @brief Get the covariance of the returns of two assets
+     * @param i The index of the first asset
+     * @param j The index of the second asset
+     * @return The covariance C_ij / (n - 1)
+     */
+    double getCovariance(size_t i, size_t j) const;
+
+    /**
+     * @brief Get the covariance matrix of the returns of the assets
+     * @return The covariance matrix, in the order of the store
+     */
+    Matrix covarianceMatrix() const;
+
+private:
+    static size_t packedIndex(size_t i, size_t j) { return i >= j ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i; }
+
+    std::vector<std::string> names;
+    std::vector<uint64_t> fingerprints;
+    size_t count = 0;
+    std::vector<double> means;
+    std::vector<double> comoments;
+};
+
+  /**
+ * @brief Update the statistics store of a directory of assets and the statistics of the assets.
+ * @details The store of the directory is loaded if it exists, synchronized with the returns of
+ * the assets and saved; the means and the standard deviations of the assets are then taken
+ * from it.
+ * @param directory The directory of the files of the assets.
+ * @param assets The assets, loaded from the directory.
+ * @param store The statistics store.
+ * @param added_days The number of days added to the store, or of the history if it has been built again.
+ * @param rebuilt True if the statistics have been built again.
+ * @return A StatisticsStoreError value that indicates the status of the function.
+ */
+StatisticsStoreError updateStatisticsStore(const std::string &directory,
+                                           std::vector<Asset> &assets,
+                                           AssetStatisticsStore &store,
+                                           size_t &added_days,
+                                           bool &rebuilt);
+
+#endif
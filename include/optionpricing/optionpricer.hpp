@@ -15,6 +15,9 @@
 #include "finance_inputmanager.hpp"
 #include "asset.hpp"
 #include "finance_montecarlo.hpp"
+#include "finance_multilevel.hpp"
+#include "finance_pathstore.hpp"
+#include "finance_statisticsstore.hpp"
 #include "optionparameters.hpp"
 #include "finance_enums.hpp"
 #include "finance_pricingutils.hpp"
@@ -29,4 +32,14 @@
  */
 void financeComputation();
 
+  /**
+ * @brief Price a book of option contracts on the same assets.
+ * @details The function loads the assets and the contracts of data/book.csv,
+ * evaluates the payoffs of all the contracts on the same simulated paths
+ * and prints the price of every contract. The paths can also be stored in
+ * data/paths.bin, and the book repriced later from the stored paths without
+ * simulating them again.
+ */
+void bookComputation();
+
 #endif
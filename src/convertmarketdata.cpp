@@ -0,0 +1,65 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <filesystem>
+
+#include "../include/optionpricing/finance_marketdata.hpp"
+
+  // Converter of the CSV files of the assets to market data files, written next to them.
+  // Every argument is a CSV file or a directory of CSV files; without arguments the
+  // directories of the single and multiple asset data are converted.
+int main(int argc, char **argv)
+{
+    std::vector<std::string> targets(argv + 1, argv + argc);
+    if (targets.empty())
+        targets = {"../data/single_asset", "../data/multi_asset"};
+
+      // Collect the CSV files
+    std::vector<std::filesystem::path> csv_files;
+    try
+    {
+        for (const std::string &target : targets)
+        {
+            if (std::filesystem::is_directory(target))
+            {
+                for (const auto &entry : std::filesystem::directory_iterator(target))
+                {
+                    if (entry.is_regular_file() && entry.path().extension() == ".csv")
+                        csv_files.emplace_back(entry.path());
+                }
+            }
+            else
+            {
+                csv_files.emplace_back(target);
+            }
+        }
+    }
+    catch (std::filesystem::filesystem_error &e)
+    {
+        std::cerr << "Could not open directory: " << e.what() << std::endl;
+        return 1;
+    }
+
+    auto start       = std::chrono::high_resolution_clock::now();
+    size_t converted = 0;
+    for (const std::filesystem::path &csv_file : csv_files)
+    {
+        std::filesystem::path binary_file = csv_file;
+        binary_file.replace_extension(MARKET_DATA_EXTENSION);
+
+        if (convertCsvToMarketData(csv_file.string(), binary_file.string()) != MarketDataError::Success)
+        {
+            std::cerr << "Error converting the file " << csv_file.string() << std::endl;
+            continue;
+        }
+
+        std::cout << csv_file.string() << " -> " << binary_file.string() << std::endl;
+        ++converted;
+    }
+    auto end      = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    std::cout << "\nConverted " << converted << " of " << csv_files.size() << " files in " << duration.count() << " ms." << std::endl;
+    return converted == csv_files.size() ? 0 : 1;
+}
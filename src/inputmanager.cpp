@@ -1,16 +1,37 @@
 #include "../include/inputmanager.hpp"
 
 void buildIntegral(size_t &n, size_t &dim, double &rad, double &edge, std::string &function,
-                   std::string &domain_type, std::vector<double> &hyper_rectangle_bounds)
+                   std::string &domain_type, std::vector<double> &hyper_rectangle_bounds, size_t &block_size, uint64_t &seed,
+                   SamplingMode &mode, size_t &replicates, SphereSampler &sphere_sampler, StoppingRule &rule, double &tolerance,
+                   bool &single_precision)
 {
+  sphere_sampler = SphereSampler::Direct;
+
     // Read and validate domain type
   readValidatedInput<std::string>("Insert the type of domain you want to integrate:\n  hc - hyper-cube\n  hs - hyper-sphere\n  hr - hyper-rectangle\n",
                                   domain_type,
                                   [](const std::string &val)
                                   { return val == "hs" || val == "hr" || val == "hc"; });
 
+    // Read the stopping rule, with a tolerance the number of points becomes the maximum
+  std::string stopping;
+  readValidatedInput<std::string>("Insert the stopping rule:\n  fixed - use exactly the given number of points\n  abs   - stop when the 95% confidence interval half-width is below an absolute tolerance\n  rel   - stop when the 95% confidence interval half-width is below a relative tolerance\n",
+                                  stopping,
+                                  [](const std::string &val)
+                                  { return val == "fixed" || val == "abs" || val == "rel"; });
+  rule      = stopping == "abs" ? StoppingRule::AbsoluteTolerance : (stopping == "rel" ? StoppingRule::RelativeTolerance : StoppingRule::FixedPoints);
+  tolerance = 0.0;
+
+  if (rule != StoppingRule::FixedPoints)
+  {
+      // Read and validate the tolerance
+    readValidatedInput<double>("Insert the tolerance:\n", tolerance, [](const double &val)
+                               { return val > 0; });
+  }
+
     // Read and validate number of random points
-  readValidatedInput<size_t>("Insert the number of random points to generate:\n", n, [](const size_t &val)
+  readValidatedInput<size_t>(rule == StoppingRule::FixedPoints ? "Insert the number of random points to generate:\n" : "Insert the maximum number of random points to generate:\n",
+                             n, [](const size_t &val)
                              { return val > 0; });
 
   if (domain_type == "hs")
@@ -22,6 +43,14 @@ void buildIntegral(size_t &n, size_t &dim, double &rad, double &edge, std::strin
       // Read and validate hypersphere radius
     readValidatedInput<double>("Insert the radius of the hypersphere:\n", rad, [](const double &val)
                                { return val > 0; });
+
+      // Read and validate the sampler of the hypersphere
+    std::string sampler;
+    readValidatedInput<std::string>("Insert the sampler of the hypersphere:\n  direct    - Gaussian direction times a radial draw\n  rejection - rejection from the bounding hypercube (low dimensions only)\n",
+                                    sampler,
+                                    [](const std::string &val)
+                                    { return val == "direct" || val == "rejection"; });
+    sphere_sampler = sampler == "rejection" ? SphereSampler::Rejection : SphereSampler::Direct;
   }
   else if (domain_type == "hr")
   {
@@ -73,4 +102,43 @@ void buildIntegral(size_t &n, size_t &dim, double &rad, double &edge, std::strin
     // Read function to integrate
   std::cout << "Insert the function to integrate:\n";
   readInput(std::cin, function);
+
+    // Read and validate the block size of the bulk evaluation
+  readValidatedInput<size_t>("Insert the number of points to evaluate per bulk call (1 to evaluate point by point):\n", block_size, [](const size_t &val)
+                             { return val > 0; });
+
+    // Read the sampling mode, quasi-random points are only available for the affine domains
+    // and with a fixed number of points
+  std::string sampling = "mc";
+  if ((domain_type == "hc" || domain_type == "hr") && rule == StoppingRule::FixedPoints)
+  {
+    readValidatedInput<std::string>("Insert the sampling mode:\n  mc     - pseudo-random points\n  sobol  - scrambled Sobol points\n  halton - randomized Halton points (low dimensions)\n",
+                                    sampling,
+                                    [&](const std::string &val)
+                                    { return val == "mc" || val == "halton" || (val == "sobol" && dim <= SobolSequence::MAX_DIMENSION); });
+  }
+  mode       = sampling == "sobol" ? SamplingMode::Sobol : (sampling == "halton" ? SamplingMode::Halton : SamplingMode::PseudoRandom);
+  replicates = 1;
+
+    // Read and validate the number of randomized replicates used to estimate the error
+  if (mode != SamplingMode::PseudoRandom)
+  {
+    readValidatedInput<size_t>("Insert the number of randomized replicates (at least 2):\n", replicates, [&](const size_t &val)
+                               { return val >= 2 && val <= n; });
+  }
+
+    // Read the precision of the random blocks, float32 numbers are drawn twice as fast
+  std::string precision = "double";
+  if (block_size > 1 && mode == SamplingMode::PseudoRandom)
+  {
+    readValidatedInput<std::string>("Insert the precision of the random points:\n  double - 52-bit uniform numbers\n  single - 24-bit uniform numbers, twice as many per SIMD register\n",
+                                    precision,
+                                    [](const std::string &val)
+                                    { return val == "double" || val == "single"; });
+  }
+  single_precision = precision == "single";
+
+    // Read the seed, the same seed and block size reproduce the same result
+  readValidatedInput<uint64_t>("Insert the seed of the random number generator:\n", seed, [](const uint64_t &)
+                               { return true; });
 }
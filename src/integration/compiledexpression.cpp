@@ -0,0 +1,417 @@
+#include "../../include/integration/compiledexpression.hpp"
+
+  // Check whether a bytecode callback is one of the built-in muParser functions
+template <typename FunctionType>
+static bool isFunction(const mu::generic_callable_type &callback, FunctionType function)
+{
+    return callback._pUserData == nullptr && callback._pRawFun == reinterpret_cast<mu::erased_fun_type>(function);
+}
+
+  // Apply an elementwise binary operation, one of the operands may be a constant
+template <typename Op>
+static inline void applyBinary(double *out, const double *a, double ca, const double *b, double cb, size_t count, Op op)
+{
+    if (a && b)
+    {
+#pragma omp simd
+        for (size_t k = 0; k < count; ++k)
+            out[k] = op(a[k], b[k]);
+    }
+    else if (a)
+    {
+#pragma omp simd
+        for (size_t k = 0; k < count; ++k)
+            out[k] = op(a[k], cb);
+    }
+    else
+    {
+#pragma omp simd
+        for (size_t k = 0; k < count; ++k)
+            out[k] = op(ca, b[k]);
+    }
+}
+
+  // Apply an elementwise unary operation
+template <typename Op>
+static inline void applyUnary(double *out, const double *a, size_t count, Op op)
+{
+#pragma omp simd
+    for (size_t k = 0; k < count; ++k)
+        out[k] = op(a[k]);
+}
+
+  // Constructor: lower the bytecode and allocate the registers
+CompiledExpression::CompiledExpression(const mu::Parser &parser, const std::vector<double> &block, size_t dim, size_t block_size)
+    :  block(block), dim(dim), block_size(block_size), num_registers(0), result(constant(0.0)), lowered(false)
+{
+    try
+    {
+        lowered = lower(parser.GetByteCode());
+    }
+    catch (mu::Parser::exception_type &e)
+    {
+        lowered = false;
+    }
+
+    if (lowered)
+        registers.assign(num_registers * block_size, 0.0);
+    else
+        program.clear();
+}
+
+  // Function returning the address of the data of an operand, nullptr for constants
+const double *CompiledExpression::address(const Operand &operand) const
+{
+    switch (operand.kind)
+    {
+    case Operand::Kind::Column:
+        return &block[operand.index * block_size];
+    case Operand::Kind::Register:
+        return &registers[operand.index * block_size];
+    default:
+        return nullptr;
+    }
+}
+
+  // Function to append an instruction writing into the register out
+CompiledExpression::Operand CompiledExpression::emit(OpCode op, size_t out, const Operand &a, const Operand &b, const Operand &c)
+{
+    Instruction instruction;
+    instruction.op      = op;
+    instruction.out     = out;
+    instruction.args[0] = a;
+    instruction.args[1] = b;
+    instruction.args[2] = c;
+    instruction.fun     = mu::generic_callable_type{nullptr, nullptr};
+    program.push_back(instruction);
+
+    num_registers = std::max(num_registers, out + 1);
+    return {Operand::Kind::Register, 0.0, out};
+}
+
+  // Function to move a constant into a register, for instructions that need an array
+CompiledExpression::Operand CompiledExpression::materialize(const Operand &operand, size_t out)
+{
+    if (operand.kind != Operand::Kind::Constant)
+        return operand;
+    return emit(OpCode::Fill, out, operand);
+}
+
+  // Function to translate the RPN bytecode into the block program.
+  // Every value on the RPN stack at position p is computed into register p,
+  // the values of the ternary operator are saved in extra registers since
+  // both branches are evaluated and then selected.
+bool CompiledExpression::lower(const mu::ParserByteCode &bytecode)
+{
+    std::vector<Operand> stack;
+    std::vector<std::pair<Operand, Operand>> branches;
+    size_t next_extra = bytecode.GetMaxStackSize();
+
+      // Binary operation: fold constants, otherwise emit the instruction
+    auto binary = [&](OpCode op, double (*fold)(double, double)) {
+        Operand b = stack.back();
+        stack.pop_back();
+        Operand a = stack.back();
+        stack.pop_back();
+        size_t position = stack.size();
+
+        if (a.kind == Operand::Kind::Constant && b.kind == Operand::Kind::Constant)
+            stack.push_back(constant(fold(a.value, b.value)));
+        else
+            stack.push_back(emit(op, position, a, b));
+    };
+
+    for (const mu::SToken *token = bytecode.GetBase(); token->Cmd != mu::cmEND; ++token)
+    {
+        size_t position = stack.size();
+
+        switch (token->Cmd)
+        {
+        case mu::cmVAL:
+            stack.push_back(constant(token->Val.data2));
+            continue;
+
+        case mu::cmVAR:
+        case mu::cmVARPOW2:
+        case mu::cmVARPOW3:
+        case mu::cmVARPOW4:
+        case mu::cmVARMUL:
+        {
+              // Map the variable address back to its column of the block
+            std::ptrdiff_t offset = token->Val.ptr - block.data();
+            if (offset < 0 || static_cast<size_t>(offset) >= dim * block_size || offset % block_size != 0)
+                return false;
+            Operand column = {Operand::Kind::Column, 0.0, static_cast<size_t>(offset) / block_size};
+
+            if (token->Cmd == mu::cmVAR)
+                stack.push_back(column);
+            else if (token->Cmd == mu::cmVARPOW2)
+                stack.push_back(emit(OpCode::Square, position, column));
+            else if (token->Cmd == mu::cmVARPOW3)
+                stack.push_back(emit(OpCode::Cube, position, column));
+            else if (token->Cmd == mu::cmVARPOW4)
+                stack.push_back(emit(OpCode::Fourth, position, column));
+            else
+                stack.push_back(emit(OpCode::MulAdd, position, column, constant(token->Val.data), constant(token->Val.data2)));
+            continue;
+        }
+
+        case mu::cmADD: binary(OpCode::Add, [](double a, double b) { return a + b; }); continue;
+        case mu::cmSUB: binary(OpCode::Sub, [](double a, double b) { return a - b; }); continue;
+        case mu::cmMUL: binary(OpCode::Mul, [](double a, double b) { return a * b; }); continue;
+        case mu::cmDIV: binary(OpCode::Div, [](double a, double b) { return a / b; }); continue;
+        case mu::cmLT:  binary(OpCode::Less, [](double a, double b) { return static_cast<double>(a < b); }); continue;
+        case mu::cmLE:  binary(OpCode::LessEqual, [](double a, double b) { return static_cast<double>(a <= b); }); continue;
+        case mu::cmGT:  binary(OpCode::Greater, [](double a, double b) { return static_cast<double>(a > b); }); continue;
+        case mu::cmGE:  binary(OpCode::GreaterEqual, [](double a, double b) { return static_cast<double>(a >= b); }); continue;
+        case mu::cmEQ:  binary(OpCode::Equal, [](double a, double b) { return static_cast<double>(a == b); }); continue;
+        case mu::cmNEQ: binary(OpCode::NotEqual, [](double a, double b) { return static_cast<double>(a != b); }); continue;
+        case mu::cmLAND: binary(OpCode::And, [](double a, double b) { return static_cast<double>(a && b); }); continue;
+        case mu::cmLOR: binary(OpCode::Or, [](double a, double b) { return static_cast<double>(a || b); }); continue;
+
+        case mu::cmPOW:
+        {
+              // Small integral exponents become products, as muParser does for variables
+            const Operand &exponent = stack.back();
+            if (exponent.kind == Operand::Kind::Constant && stack[position - 2].kind != Operand::Kind::Constant &&
+                (exponent.value == 2.0 || exponent.value == 3.0 || exponent.value == 4.0))
+            {
+                OpCode op = exponent.value == 2.0 ? OpCode::Square : (exponent.value == 3.0 ? OpCode::Cube : OpCode::Fourth);
+                stack.pop_back();
+                Operand base = stack.back();
+                stack.pop_back();
+                stack.push_back(emit(op, position - 2, base));
+            }
+            else
+            {
+                binary(OpCode::Pow, [](double a, double b) { return std::pow(a, b); });
+            }
+            continue;
+        }
+
+        case mu::cmFUNC:
+        {
+            const mu::generic_callable_type &callback = token->Fun.cb;
+            int argc = token->Fun.argc;
+
+            if (argc == 0)
+            {
+                Instruction call = {OpCode::Call0, position, {constant(0.0), constant(0.0), constant(0.0)}, callback};
+                program.push_back(call);
+                num_registers = std::max(num_registers, position + 1);
+                stack.push_back({Operand::Kind::Register, 0.0, position});
+            }
+            else if (argc == 1)
+            {
+                Operand a = stack.back();
+                stack.pop_back();
+                position = stack.size();
+
+                OpCode op = OpCode::Call1;
+                if (isFunction(callback, &mu::MathImpl<double>::UnaryMinus))
+                    op = OpCode::Negate;
+                else if (isFunction(callback, &mu::MathImpl<double>::Abs))
+                    op = OpCode::Abs;
+                else if (isFunction(callback, &mu::MathImpl<double>::Sqrt))
+                    op = OpCode::Sqrt;
+                else if (isFunction(callback, &mu::MathImpl<double>::Exp))
+                    op = OpCode::Exp;
+                else if (isFunction(callback, &mu::MathImpl<double>::Log))
+                    op = OpCode::Log;
+                else if (isFunction(callback, &mu::MathImpl<double>::Sin))
+                    op = OpCode::Sin;
+                else if (isFunction(callback, &mu::MathImpl<double>::Cos))
+                    op = OpCode::Cos;
+
+                if (op != OpCode::Call1 && a.kind == Operand::Kind::Constant)
+                {
+                    stack.push_back(constant(callback.call_fun<1>(a.value)));
+                }
+                else
+                {
+                    stack.push_back(emit(op, position, materialize(a, position)));
+                    program.back().fun = callback;
+                }
+            }
+            else if (argc == 2 || argc == 3)
+            {
+                Operand args[3] = {constant(0.0), constant(0.0), constant(0.0)};
+                position = stack.size() - argc;
+                for (int i = 0; i < argc; ++i)
+                    args[i] = materialize(stack[position + i], position + i);
+                stack.resize(position);
+
+                stack.push_back(emit(argc == 2 ? OpCode::Call2 : OpCode::Call3, position, args[0], args[1], args[2]));
+                program.back().fun = callback;
+            }
+            else if (argc < 0 && (isFunction(callback, &mu::MathImpl<double>::Sum) || isFunction(callback, &mu::MathImpl<double>::Avg) ||
+                                  isFunction(callback, &mu::MathImpl<double>::Min) || isFunction(callback, &mu::MathImpl<double>::Max)))
+            {
+                  // Multi-argument built-ins become a left-to-right chain of binary operations,
+                  // in the same order as muParser
+                int n = -argc;
+                std::vector<Operand> args(stack.end() - n, stack.end());
+                stack.resize(stack.size() - n);
+                stack.push_back(args[0]);
+
+                bool is_min = isFunction(callback, &mu::MathImpl<double>::Min);
+                bool is_max = isFunction(callback, &mu::MathImpl<double>::Max);
+                for (int i = 1; i < n; ++i)
+                {
+                    stack.push_back(args[i]);
+                    if (is_min)
+                        binary(OpCode::Min, [](double a, double b) { return std::min(a, b); });
+                    else if (is_max)
+                        binary(OpCode::Max, [](double a, double b) { return std::max(a, b); });
+                    else
+                        binary(OpCode::Add, [](double a, double b) { return a + b; });
+                }
+
+                if (isFunction(callback, &mu::MathImpl<double>::Avg))
+                {
+                    stack.push_back(constant(static_cast<double>(n)));
+                    binary(OpCode::Div, [](double a, double b) { return a / b; });
+                }
+            }
+            else
+            {
+                return false;
+            }
+            continue;
+        }
+
+        case mu::cmIF:
+        {
+            Operand condition = stack.back();
+            stack.pop_back();
+            if (condition.kind == Operand::Kind::Register)
+                condition = emit(OpCode::Copy, next_extra++, condition);
+            branches.push_back({condition, constant(0.0)});
+            continue;
+        }
+
+        case mu::cmELSE:
+        {
+            Operand value = stack.back();
+            stack.pop_back();
+            if (value.kind == Operand::Kind::Register)
+                value = emit(OpCode::Copy, next_extra++, value);
+            branches.back().second = value;
+            continue;
+        }
+
+        case mu::cmENDIF:
+        {
+            Operand otherwise = stack.back();
+            stack.pop_back();
+            Operand condition = branches.back().first;
+            Operand then      = branches.back().second;
+            branches.pop_back();
+            position = stack.size();
+
+            if (condition.kind == Operand::Kind::Constant)
+                stack.push_back(condition.value != 0.0 ? then : otherwise);
+            else
+                stack.push_back(emit(OpCode::Select, position, condition, materialize(then, next_extra++), materialize(otherwise, position)));
+            continue;
+        }
+
+        default:
+              // String functions, bulk callbacks, assignments and user operators are left to muParser
+            return false;
+        }
+    }
+
+    if (stack.size() != 1 || !branches.empty())
+        return false;
+
+    result = stack.back();
+    return true;
+}
+
+  // Function to run the block program on the first count points of the block
+void CompiledExpression::evaluate(std::vector<double> &results, size_t count)
+{
+    for (const Instruction &instruction : program)
+    {
+        double *out     = &registers[instruction.out * block_size];
+        const double *a = address(instruction.args[0]);
+        const double *b = address(instruction.args[1]);
+        const double *c = address(instruction.args[2]);
+        double ca       = instruction.args[0].value;
+        double cb       = instruction.args[1].value;
+        double cc       = instruction.args[2].value;
+        const mu::generic_callable_type &fun = instruction.fun;
+
+        switch (instruction.op)
+        {
+        case OpCode::Fill:
+            std::fill(out, out + count, ca);
+            break;
+        case OpCode::Copy:
+            std::copy(a, a + count, out);
+            break;
+        case OpCode::Add: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return x + y; }); break;
+        case OpCode::Sub: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return x - y; }); break;
+        case OpCode::Mul: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return x * y; }); break;
+        case OpCode::Div: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return x / y; }); break;
+        case OpCode::Min: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return std::min(x, y); }); break;
+        case OpCode::Max: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return std::max(x, y); }); break;
+        case OpCode::Less: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return x < y ? 1.0 : 0.0; }); break;
+        case OpCode::LessEqual: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return x <= y ? 1.0 : 0.0; }); break;
+        case OpCode::Greater: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return x > y ? 1.0 : 0.0; }); break;
+        case OpCode::GreaterEqual: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return x >= y ? 1.0 : 0.0; }); break;
+        case OpCode::Equal: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return x == y ? 1.0 : 0.0; }); break;
+        case OpCode::NotEqual: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return x != y ? 1.0 : 0.0; }); break;
+        case OpCode::And: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return (x != 0.0 ? 1.0 : 0.0) * (y != 0.0 ? 1.0 : 0.0); }); break;
+        case OpCode::Or: applyBinary(out, a, ca, b, cb, count, [](double x, double y) { return std::max(x != 0.0 ? 1.0 : 0.0, y != 0.0 ? 1.0 : 0.0); }); break;
+        case OpCode::Pow:
+            for (size_t k = 0; k < count; ++k)
+                out[k] = std::pow(a ? a[k] : ca, b ? b[k] : cb);
+            break;
+        case OpCode::Square: applyUnary(out, a, count, [](double x) { return x * x; }); break;
+        case OpCode::Cube: applyUnary(out, a, count, [](double x) { return x * x * x; }); break;
+        case OpCode::Fourth: applyUnary(out, a, count, [](double x) { return x * x * x * x; }); break;
+        case OpCode::MulAdd: applyUnary(out, a, count, [cb, cc](double x) { return x * cb + cc; }); break;
+        case OpCode::Negate: applyUnary(out, a, count, [](double x) { return -x; }); break;
+        case OpCode::Abs: applyUnary(out, a, count, [](double x) { return std::fabs(x); }); break;
+        case OpCode::Sqrt: applyUnary(out, a, count, [](double x) { return std::sqrt(x); }); break;
+        case OpCode::Exp: vectorExp(a, out, count); break;
+        case OpCode::Log: vectorLog(a, out, count); break;
+        case OpCode::Sin: vectorSin(a, out, count); break;
+        case OpCode::Cos: vectorCos(a, out, count); break;
+        case OpCode::Call0:
+            for (size_t k = 0; k < count; ++k)
+                out[k] = fun.call_fun<0>();
+            break;
+        case OpCode::Call1:
+            for (size_t k = 0; k < count; ++k)
+                out[k] = fun.call_fun<1>(a[k]);
+            break;
+        case OpCode::Call2:
+            for (size_t k = 0; k < count; ++k)
+                out[k] = fun.call_fun<2>(a[k], b[k]);
+            break;
+        case OpCode::Call3:
+            for (size_t k = 0; k < count; ++k)
+                out[k] = fun.call_fun<3>(a[k], b[k], c[k]);
+            break;
+        case OpCode::Select:
+#pragma omp simd
+            for (size_t k = 0; k < count; ++k)
+            {
+                double x = b[k];
+                double y = c[k];
+                out[k] = a[k] != 0.0 ? x : y;
+            }
+            break;
+        }
+    }
+
+      // Write the final value of the stack
+    const double *value = address(result);
+    if (value)
+        std::copy(value, value + count, results.begin());
+    else
+        std::fill(results.begin(), results.begin() + count, result.value);
+}
@@ -25,4 +25,67 @@ double evaluateFunction(const std::string &expression, const std::vector<double>
           // Return some default value in case of an error
         return 0.0;
     }
-}
\ No newline at end of file
+}
+
+  // Constructor: bind the variables to the point buffer and parse the expression once
+FunctionEvaluator::FunctionEvaluator(const std::string &expression, size_t dim)
+    :  point(dim, 0.0)
+{
+    try
+    {
+        for (size_t i = 0; i < dim; ++i)
+        {
+            parser.DefineVar("x" + std::to_string(i + 1), &point[i]);
+        }
+        parser.SetExpr(expression);
+
+          // The first evaluation builds the bytecode, later calls only run it
+        parser.Eval();
+    }
+    catch (mu::Parser::exception_type &e)
+    {
+        std::cout << "Error evaluating expression: " << e.GetMsg() << std::endl;
+    }
+}
+
+  // Constructor: bind every variable to its own column of the block buffer
+BulkFunctionEvaluator::BulkFunctionEvaluator(const std::string &expression, size_t dim, size_t block_size)
+    :  block_size(block_size), block(dim * block_size, 0.0)
+{
+    try
+    {
+        for (size_t i = 0; i < dim; ++i)
+        {
+            parser.DefineVar("x" + std::to_string(i + 1), &block[i * block_size]);
+        }
+        parser.SetExpr(expression);
+
+          // The first evaluation builds the bytecode, which is then lowered to a block program
+        parser.Eval();
+        compiled = std::make_unique<CompiledExpression>(parser, block, dim, block_size);
+    }
+    catch (mu::Parser::exception_type &e)
+    {
+        std::cout << "Error evaluating expression: " << e.GetMsg() << std::endl;
+    }
+}
+
+  // Function to evaluate the function over a block of points with one bulk call
+void BulkFunctionEvaluator::evaluate(std::vector<double> &results, size_t count)
+{
+    if (isCompiled())
+    {
+        compiled->evaluate(results, count);
+        return;
+    }
+
+    try
+    {
+        parser.Eval(results.data(), static_cast<int>(count));
+    }
+    catch (mu::Parser::exception_type &e)
+    {
+        std::cout << "Error evaluating expression: " << e.GetMsg() << std::endl;
+        std::fill(results.begin(), results.begin() + count, 0.0);
+    }
+}
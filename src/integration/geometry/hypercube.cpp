@@ -2,16 +2,32 @@
 
   // Constructor
 HyperCube::HyperCube(size_t dim, double edge)
-    :  edge(edge), dimension(dim), volume(1.0), eng(rd()) {}
+    :  edge(edge), dimension(dim), volume(1.0) {}
 
   // Functions that generate a random point in the hypercube
-  // by parallelizing the generation for each dimension
   // This function is used in the Monte Carlo method of the original project
-void HyperCube::generateRandomPoint(std::vector<double> &random_point)
+void HyperCube::generateRandomPoint(std::vector<double> &random_point, RandomStream &stream)
 {
-    std::uniform_real_distribution<double> distribution(-edge / 2, edge / 2);
+    for (size_t i = 0; i < dimension; ++i)
+        random_point[i] = stream.uniform(-edge / 2, edge / 2);
+}
 
-#pragma omp parallel for
+  // Function that generates a block of random points in the hypercube,
+  // one contiguous column per dimension
+void HyperCube::generateRandomBlock(std::vector<double> &random_block, size_t block_size, size_t count, RandomStream &stream, std::vector<double> &scratch)
+{
+    for (size_t i = 0; i < dimension; ++i)
+        stream.fillUniform(&random_block[i * block_size], count, -edge / 2, edge / 2);
+}
+
+  // Function that maps a block of points of the unit cube into the hypercube
+void HyperCube::mapFromUnitCube(std::vector<double> &random_block, size_t block_size, size_t count)
+{
     for (size_t i = 0; i < dimension; ++i)
-        random_point[i] = distribution(eng);
-}
\ No newline at end of file
+    {
+        double *column = &random_block[i * block_size];
+#pragma omp simd
+        for (size_t k = 0; k < count; ++k)
+            column[k] = edge * column[k] - edge / 2;
+    }
+}
@@ -2,18 +2,39 @@
 
   // Constructor
 HyperRectangle::HyperRectangle(size_t dim, std::vector<double> &hyper_rectangle_bounds)
-    :  hyper_rectangle_bounds(hyper_rectangle_bounds), volume(1.0), dimension(dim), eng(rd()) {}
+    :  hyper_rectangle_bounds(hyper_rectangle_bounds), volume(1.0), dimension(dim) {}
 
   // Function to generate a random point in the hyperrectangle domain
   // for the Monte Carlo method of the original project
-void HyperRectangle::generateRandomPoint(std::vector<double> &random_point)
+void HyperRectangle::generateRandomPoint(std::vector<double> &random_point, RandomStream &stream)
 {
     int j = 0;
     for (size_t i = 0; i < dimension * 2 - 1; i += 2)
     {
           // Generate random points by following the uniform distribution
-        std::uniform_real_distribution<double> distribution(hyper_rectangle_bounds[i], hyper_rectangle_bounds[i + 1]);
-        random_point[j] = distribution(eng);
+        random_point[j] = stream.uniform(hyper_rectangle_bounds[i], hyper_rectangle_bounds[i + 1]);
         j++;
     }
 }
+
+  // Function to generate a block of random points in the hyperrectangle domain,
+  // one contiguous column per dimension
+void HyperRectangle::generateRandomBlock(std::vector<double> &random_block, size_t block_size, size_t count, RandomStream &stream, std::vector<double> &scratch)
+{
+    for (size_t i = 0; i < dimension; ++i)
+        stream.fillUniform(&random_block[i * block_size], count, hyper_rectangle_bounds[2 * i], hyper_rectangle_bounds[2 * i + 1]);
+}
+
+  // Function that maps a block of points of the unit cube into the hyperrectangle
+void HyperRectangle::mapFromUnitCube(std::vector<double> &random_block, size_t block_size, size_t count)
+{
+    for (size_t i = 0; i < dimension; ++i)
+    {
+        double lower = hyper_rectangle_bounds[2 * i];
+        double width = hyper_rectangle_bounds[2 * i + 1] - lower;
+        double *column = &random_block[i * block_size];
+#pragma omp simd
+        for (size_t k = 0; k < count; ++k)
+            column[k] = lower + width * column[k];
+    }
+}
@@ -1,27 +1,140 @@
 #include "../../../include/integration/geometry/hypersphere.hpp"
 
   // Constructor
-HyperSphere::HyperSphere(size_t dim, double rad)
-    :  radius(rad), parameter(dim / 2.0), volume(1.0), dimension(dim), eng(rd()) {}
+HyperSphere::HyperSphere(size_t dim, double rad, SphereSampler sampler)
+    :  radius(rad), parameter(dim / 2.0), volume(1.0), dimension(dim), sampler(sampler), uniforms_drawn(0), points_generated(0) {}
 
   // Function to generate a random point in the hypersphere domain
   // for the Monte Carlo method of the original project
-void HyperSphere::generateRandomPoint(std::vector<double> &random_point)
+void HyperSphere::generateRandomPoint(std::vector<double> &random_point, RandomStream &stream)
 {
-    bool point_within_sphere = false;
-    std::uniform_real_distribution<double> distribution(-radius, radius);
+    uint64_t start = stream.getDrawn();
 
-    while (!point_within_sphere)
+    samplePoint(random_point, stream);
+
+    uniforms_drawn.fetch_add(stream.getDrawn() - start, std::memory_order_relaxed);
+    points_generated.fetch_add(1, std::memory_order_relaxed);
+}
+
+  // Function to draw one point with the sampler of the hypersphere, without counting it
+void HyperSphere::samplePoint(std::vector<double> &random_point, RandomStream &stream)
+{
+    if (sampler == SphereSampler::Rejection)
+    {
+        bool point_within_sphere = false;
+
+        while (!point_within_sphere)
+        {
+            double sum_of_squares = 0.0;
+
+            for (size_t i = 0; i < dimension; ++i)
+            {
+                random_point[i] = stream.uniform(-radius, radius);
+
+                sum_of_squares += random_point[i] * random_point[i];
+            }
+
+            point_within_sphere = (sum_of_squares <= radius * radius);
+        }
+    }
+    else
     {
         double sum_of_squares = 0.0;
 
-        for (size_t i = 0; i < dimension; ++i)
+          // Gaussian direction, two coordinates per Box-Muller pair
+        while (sum_of_squares == 0.0)
         {
-            random_point[i] = distribution(eng);
+            for (size_t i = 0; i < dimension; i += 2)
+            {
+                double r     = std::sqrt(-2.0 * std::log(1.0 - stream.uniform()));
+                double theta = 2.0 * PI * stream.uniform();
+
+                random_point[i] = r * std::cos(theta);
+                if (i + 1 < dimension)
+                    random_point[i + 1] = r * std::sin(theta);
+            }
 
-            sum_of_squares += random_point[i] * random_point[i];
+            sum_of_squares = 0.0;
+            for (size_t i = 0; i < dimension; ++i)
+                sum_of_squares += random_point[i] * random_point[i];
         }
 
-        point_within_sphere = (sum_of_squares <= radius * radius);
+          // Radial draw with density proportional to r^(d-1)
+        double scale = radius * std::pow(1.0 - stream.uniform(), 1.0 / static_cast<double>(dimension)) / std::sqrt(sum_of_squares);
+        for (size_t i = 0; i < dimension; ++i)
+            random_point[i] *= scale;
+    }
+}
+
+  // Function to generate a block of random points in the hypersphere domain
+void HyperSphere::generateRandomBlock(std::vector<double> &random_block, size_t block_size, size_t count, RandomStream &stream, std::vector<double> &scratch)
+{
+    if (sampler == SphereSampler::Direct)
+    {
+        generateDirectBlock(random_block, block_size, count, stream, scratch);
+        return;
     }
-}
\ No newline at end of file
+
+      // Each point is accepted or rejected as a whole and then scattered in the block,
+      // the shared counters are updated once per block. The point is drawn in the scratch buffer
+    uint64_t start = stream.getDrawn();
+    if (scratch.size() < dimension)
+        scratch.resize(dimension);
+
+    for (size_t k = 0; k < count; ++k)
+    {
+        samplePoint(scratch, stream);
+
+        for (size_t i = 0; i < dimension; ++i)
+            random_block[i * block_size + k] = scratch[i];
+    }
+
+    uniforms_drawn.fetch_add(stream.getDrawn() - start, std::memory_order_relaxed);
+    points_generated.fetch_add(count, std::memory_order_relaxed);
+}
+
+  // Function to generate a block with the direct sampler: every step works on whole
+  // columns of the block, so the transcendental functions run in SIMD loops
+void HyperSphere::generateDirectBlock(std::vector<double> &random_block, size_t block_size, size_t count, RandomStream &stream, std::vector<double> &scratch)
+{
+    uint64_t start = stream.getDrawn();
+
+      // Two scratch columns, the radial factors and the sums of squares of the points
+    if (scratch.size() < 2 * count)
+        scratch.resize(2 * count);
+    double *first          = scratch.data();
+    double *sum_of_squares = scratch.data() + count;
+    std::fill_n(sum_of_squares, count, 0.0);
+
+      // Gaussian direction, one column of normal numbers per coordinate
+    for (size_t i = 0; i < dimension; ++i)
+    {
+        double *column = &random_block[i * block_size];
+        stream.fillNormal(column, count);
+
+#pragma omp simd
+        for (size_t k = 0; k < count; ++k)
+            sum_of_squares[k] += column[k] * column[k];
+    }
+
+      // Radial draw: radius * U^(1/d) = radius * exp(log(U) / d)
+    double inverse_dimension = 1.0 / static_cast<double>(dimension);
+    stream.fillUniform(first, count, 0.0, 1.0);
+#pragma omp simd
+    for (size_t k = 0; k < count; ++k)
+    {
+        double norm = sum_of_squares[k] > 0.0 ? sum_of_squares[k] : 1.0;
+        first[k] = radius * simdExp(simdLog(1.0 - first[k]) * inverse_dimension) / std::sqrt(norm);
+    }
+
+    for (size_t i = 0; i < dimension; ++i)
+    {
+        double *column = &random_block[i * block_size];
+#pragma omp simd
+        for (size_t k = 0; k < count; ++k)
+            column[k] *= first[k];
+    }
+
+    uniforms_drawn.fetch_add(stream.getDrawn() - start, std::memory_order_relaxed);
+    points_generated.fetch_add(count, std::memory_order_relaxed);
+}
@@ -1,7 +1,8 @@
 #include "../../include/integration/integralcalculator.hpp"
 
   // Function to create the geometry object based on the domain type
-Geometry *geometryFactory(size_t dim, double rad, double edge, std::vector<double> &hyper_rectangle_bounds, std::string domain_type)
+Geometry *geometryFactory(size_t dim, double rad, double edge, std::vector<double> &hyper_rectangle_bounds, std::string domain_type,
+                          SphereSampler sphere_sampler)
 {
     if (domain_type == "hr")
     {
@@ -9,7 +10,7 @@ Geometry *geometryFactory(size_t dim, double rad, double edge, std::vector<doubl
     }
     else if (domain_type == "hs")
     {
-        return new HyperSphere(dim, rad);
+        return new HyperSphere(dim, rad, sphere_sampler);
     }
     else if (domain_type == "hc")
     {
@@ -24,7 +25,15 @@ Geometry *geometryFactory(size_t dim, double rad, double edge, std::vector<doubl
   // Function to compute the integral using the Monte Carlo method
 void integralCalculator()
 {
-    size_t n, dim;
+    size_t n, dim, block_size;
+    uint64_t seed;
+    SamplingMode mode;
+    size_t replicates;
+    SphereSampler sphere_sampler;
+    StoppingRule rule;
+    double tolerance;
+    size_t max_points;
+    bool single_precision;
     double rad, edge, variance, standard_error = 0.0;
     std::string function;
     std::string domain_type;
@@ -33,10 +42,11 @@ void integralCalculator()
     bool success = false;
 
       // Get the input parameters
-    buildIntegral(n, dim, rad, edge, function, domain_type, hyper_rectangle_bounds);
+    buildIntegral(n, dim, rad, edge, function, domain_type, hyper_rectangle_bounds, block_size, seed, mode, replicates, sphere_sampler, rule, tolerance, single_precision);
+    max_points = n;
 
       // Create the geometry object based on the domain type
-    std::unique_ptr<Geometry> geometry(geometryFactory(dim, rad, edge, hyper_rectangle_bounds, domain_type));
+    std::unique_ptr<Geometry> geometry(geometryFactory(dim, rad, edge, hyper_rectangle_bounds, domain_type, sphere_sampler));
 
     if (geometry)
     {
@@ -50,8 +60,11 @@ void integralCalculator()
         }
         else
         {
-              // Calculate the integral using the Monte Carlo method
-            result         = montecarloIntegration(n, function, *geometry, variance);
+              // Calculate the integral using the Monte Carlo method, with a fixed number of points or to a target precision
+            if (rule == StoppingRule::FixedPoints)
+                result = montecarloIntegration(n, function, *geometry, variance, block_size, seed, mode, replicates, single_precision);
+            else
+                result = adaptiveMontecarloIntegration(max_points, function, *geometry, variance, n, rule, tolerance, block_size, seed, single_precision);
             standard_error = std::sqrt(variance / static_cast<double>(n)) * geometry->getVolume();
             if (result.first != 0.0 && result.second != 0.0)
                 success = true;
@@ -82,6 +95,27 @@ void integralCalculator()
             std::cout << "This may be due to the high variability of the integrated function." << std::endl;
         }
         std::cout << "\nThe time needed to calculate the integral is: " << result.second * 1e-6 << " seconds" << std::endl;
+        if (rule != StoppingRule::FixedPoints)
+        {
+            std::cout << "Points used: " << n << " (maximum " << max_points << ")" << std::endl;
+            if (!targetPrecisionReached(result.first, standard_error, rule, tolerance))
+                std::cout << "Warning: the maximum number of points was reached before the target precision." << std::endl;
+        }
+        std::cout << "Points evaluated per bulk call: " << block_size << std::endl;
+        std::cout << "Seed: " << seed << std::endl;
+        if (single_precision)
+            std::cout << "Precision of the random points: single" << std::endl;
+        if (auto *sphere = dynamic_cast<HyperSphere *>(geometry.get()))
+            std::cout << "Uniforms drawn per accepted point: " << sphere->getUniformsPerPoint() << std::endl;
+        if (mode != SamplingMode::PseudoRandom)
+        {
+              // The replicates actually used, the engine clamps and raises the requested number
+            replicates = qmcReplicates(mode, n, replicates);
+            std::cout << "Sampling: " << (mode == SamplingMode::Sobol ? "scrambled Sobol" : "randomized Halton") << ", " << replicates << " replicates of " << n / replicates;
+            if (n % replicates != 0)
+                std::cout << " or " << n / replicates + 1;
+            std::cout << " points" << std::endl;
+        }
     }
     else if (success && function == "1")
     {
@@ -0,0 +1,181 @@
+#include "../../include/integration/qmcsequence.hpp"
+
+  // Reverse the order of the bits of a 32-bit integer
+static inline uint32_t reverseBits(uint32_t x)
+{
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+  // Hash-based nested uniform scrambling: on the reversed bits, every output bit
+  // only depends on the input bits below it, which is an Owen scramble of the digits
+static inline uint32_t owenScramble(uint32_t x, uint32_t seed)
+{
+    x = reverseBits(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return reverseBits(x);
+}
+
+  // Draw 32 random bits from a stream
+static inline uint32_t randomBits(RandomStream &stream)
+{
+    return static_cast<uint32_t>(stream.uniform() * 4294967296.0);
+}
+
+  // Constructor: build the 32 direction numbers of every dimension
+SobolSequence::SobolSequence(size_t dim, uint64_t seed, uint64_t replicate)
+    :  directions(dim * 32), scramble_seeds(dim)
+{
+    dimension = dim;
+
+      // The first dimension is the van der Corput sequence in base 2
+    for (size_t k = 0; k < 32; ++k)
+        directions[k] = 1u << (31 - k);
+
+    size_t offset = 0;
+    for (size_t j = 1; j < dim; ++j)
+    {
+        uint32_t polynomial = SOBOL_POLYNOMIALS[j - 1];
+        size_t degree = 0;
+        while ((polynomial >> (degree + 1)) != 0)
+            ++degree;
+
+        uint32_t *v = &directions[j * 32];
+        for (size_t k = 0; k < degree && k < 32; ++k)
+            v[k] = static_cast<uint32_t>(SOBOL_INITIAL_NUMBERS[offset + k]) << (31 - k);
+        offset += degree;
+
+          // Recurrence v_k = v_{k-s} ^ (v_{k-s} >> s) ^ sum_i a_i v_{k-i}
+        for (size_t k = degree; k < 32; ++k)
+        {
+            uint32_t value = v[k - degree] ^ (v[k - degree] >> degree);
+            for (size_t i = 1; i < degree; ++i)
+            {
+                if ((polynomial >> (degree - i)) & 1u)
+                    value ^= v[k - i];
+            }
+            v[k] = value;
+        }
+    }
+
+    RandomStream stream(seed, replicate);
+    for (size_t j = 0; j < dim; ++j)
+        scramble_seeds[j] = randomBits(stream);
+}
+
+  // Function to generate the points first..first+count-1, starting from the Gray code of first;
+  // first + count must not exceed MAX_POINTS
+void SobolSequence::generateBlock(std::vector<double> &block, size_t block_size, uint64_t first, size_t count) const
+{
+    uint64_t gray = first ^ (first >> 1);
+
+    for (size_t j = 0; j < dimension; ++j)
+    {
+        const uint32_t *v = &directions[j * 32];
+        double *column    = &block[j * block_size];
+
+          // Skip ahead: the point of index first is the XOR of the directions of its Gray code
+        uint32_t x = 0;
+        for (size_t k = 0; k < 32; ++k)
+        {
+            if ((gray >> k) & 1u)
+                x ^= v[k];
+        }
+
+          // Consecutive Gray codes differ by the bit of the trailing zeros of the next index,
+          // the last point does not step, so the index 2^32 is never reached. The raw bits
+          // are stored in the column, a double holds them exactly
+        for (size_t k = 0; k + 1 < count; ++k)
+        {
+            column[k] = static_cast<double>(x);
+            x ^= v[__builtin_ctzll(first + k + 1)];
+        }
+        if (count > 0)
+            column[count - 1] = static_cast<double>(x);
+
+          // Scramble the column in place
+        uint32_t seed = scramble_seeds[j];
+#pragma omp simd
+        for (size_t k = 0; k < count; ++k)
+            column[k] = (static_cast<double>(owenScramble(static_cast<uint32_t>(column[k]), seed)) + 0.5) * (1.0 / 4294967296.0);
+    }
+}
+
+  // Constructor: the first dim primes are the bases, the shifts randomize the sequence
+HaltonSequence::HaltonSequence(size_t dim, uint64_t seed, uint64_t replicate)
+    :  shifts(dim)
+{
+    dimension = dim;
+
+    for (uint64_t candidate = 2; bases.size() < dim; ++candidate)
+    {
+        bool is_prime = true;
+        for (uint64_t base : bases)
+        {
+            if (base * base > candidate)
+                break;
+            if (candidate % base == 0)
+            {
+                is_prime = false;
+                break;
+            }
+        }
+        if (is_prime)
+            bases.push_back(candidate);
+    }
+
+    RandomStream stream(seed, replicate);
+    for (size_t j = 0; j < dim; ++j)
+        shifts[j] = stream.uniform();
+}
+
+  // Function to generate the points first..first+count-1 by direct radical inversion
+void HaltonSequence::generateBlock(std::vector<double> &block, size_t block_size, uint64_t first, size_t count) const
+{
+    for (size_t j = 0; j < dimension; ++j)
+    {
+        uint64_t base = bases[j];
+        double inverse_base = 1.0 / static_cast<double>(base);
+        double *column = &block[j * block_size];
+
+        for (size_t k = 0; k < count; ++k)
+        {
+            uint64_t index = first + k;
+            double value = 0.0;
+            double scale = inverse_base;
+            while (index > 0)
+            {
+                value += scale * static_cast<double>(index % base);
+                index /= base;
+                scale *= inverse_base;
+            }
+
+            value += shifts[j];
+            column[k] = value >= 1.0 ? value - 1.0 : value;
+        }
+    }
+}
+
+  // Function to create the sequence of a sampling mode
+QmcSequence *qmcSequenceFactory(SamplingMode mode, size_t dim, uint64_t seed, uint64_t replicate)
+{
+    if (mode == SamplingMode::Sobol)
+    {
+        return new SobolSequence(dim, seed, replicate);
+    }
+    else if (mode == SamplingMode::Halton)
+    {
+        return new HaltonSequence(dim, seed, replicate);
+    }
+    else
+    {
+        return nullptr;
+    }
+}
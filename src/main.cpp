@@ -21,7 +21,7 @@ int main()
   while (!validChoice)
   {
       // Display the menu
-    std::cout << "What you want to do?\n1. Price an option\n2. Calculate an integral\nEnter choice (1 or 2): ";
+    std::cout << "What you want to do?\n1. Price an option\n2. Calculate an integral\n3. Price a book of options\nEnter choice (1, 2 or 3): ";
 
     std::cin >> choice;
 
@@ -48,8 +48,13 @@ int main()
         integralCalculator();
         validChoice = true;
         break;
+      case 3: 
+          // Call the option book function
+        bookComputation();
+        validChoice = true;
+        break;
       default: 
-        std::cout << "Invalid choice. Please enter 1 or 2." << std::endl;
+        std::cout << "Invalid choice. Please enter 1, 2 or 3." << std::endl;
         break;
       }
     }
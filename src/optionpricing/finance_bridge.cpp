@@ -0,0 +1,92 @@
+#include "../../include/optionpricing/finance_bridge.hpp"
+
+  // Constructor: the order of construction of the points of the path, with the
+  // weights of the two known ends and the conditional standard deviation of every point
+BrownianBridge::BrownianBridge(size_t num_steps)
+    :  num_steps(num_steps), bridge_index(num_steps), left_index(num_steps), right_index(num_steps),
+       left_weight(num_steps), right_weight(num_steps), std_dev(num_steps)
+{
+      // The point s is at time s + 1, in units of the time step
+    std::vector<bool> known(num_steps, false);
+
+      // The first number sets the last point
+    known[num_steps - 1] = true;
+    bridge_index[0]      = num_steps - 1;
+    std_dev[0]           = std::sqrt(static_cast<double>(num_steps));
+
+    size_t j = 0;
+    for (size_t i = 1; i < num_steps; ++i)
+    {
+          // Next interval of unknown points, j..k-1, between the known points j-1 and k
+        while (known[j])
+            ++j;
+        size_t k = j;
+        while (!known[k])
+            ++k;
+
+          // Its midpoint, conditionally on the two ends
+        size_t l = j + ((k - 1 - j) >> 1);
+        double width = static_cast<double>(k + 1 - j);
+        known[l]        = true;
+        bridge_index[i] = l;
+        left_index[i]   = j;
+        right_index[i]  = k;
+        left_weight[i]  = static_cast<double>(k - l) / width;
+        right_weight[i] = static_cast<double>(l + 1 - j) / width;
+        std_dev[i]      = std::sqrt(static_cast<double>(l + 1 - j) * static_cast<double>(k - l) / width);
+
+        j = k + 1;
+        if (j >= num_steps)
+            j = 0;
+    }
+}
+
+  // Function to build the increments of a block of paths, one SIMD loop over the paths per point
+template <typename T>
+void BrownianBridge::build(const double *normals, size_t stride, size_t paths, T *increments) const
+{
+      // The points of the paths are built in place, then differenced
+    T *last = &increments[bridge_index[0] * paths];
+    T scale = static_cast<T>(std_dev[0]);
+#pragma omp simd
+    for (size_t p = 0; p < paths; ++p)
+        last[p] = scale * static_cast<T>(normals[p]);
+
+    for (size_t i = 1; i < num_steps; ++i)
+    {
+        const double *z = &normals[i * stride];
+        const T *right  = &increments[right_index[i] * paths];
+        T *point        = &increments[bridge_index[i] * paths];
+        T wr = static_cast<T>(right_weight[i]);
+        T sd = static_cast<T>(std_dev[i]);
+
+        if (left_index[i] == 0)
+        {
+#pragma omp simd
+            for (size_t p = 0; p < paths; ++p)
+                point[p] = wr * right[p] + sd * static_cast<T>(z[p]);
+        }
+        else
+        {
+            const T *left = &increments[(left_index[i] - 1) * paths];
+            T wl = static_cast<T>(left_weight[i]);
+#pragma omp simd
+            for (size_t p = 0; p < paths; ++p)
+                point[p] = wl * left[p] + wr * right[p] + sd * static_cast<T>(z[p]);
+        }
+    }
+
+      // Increments of the steps, from the last one so that every point is read before it changes
+    for (size_t s = num_steps - 1; s > 0; --s)
+    {
+        T *current        = &increments[s * paths];
+        const T *previous = &increments[(s - 1) * paths];
+#pragma omp simd
+        for (size_t p = 0; p < paths; ++p)
+            current[p] -= previous[p];
+    }
+}
+
+  // Instantiations used by the pricing kernels
+template void BrownianBridge::build<float>(const double *, size_t, size_t, float *) const;
+template void BrownianBridge::build<double>(const double *, size_t, size_t, double *) const;
@@ -1,25 +1,33 @@
 #include "../../include/optionpricing/finance_inputmanager.hpp"
 
+#include <cstring>
+
 double logReturn(const double price, const double previous_price)
 {
     return std::log(price / previous_price);
 }
 
-  // Function to load assets from CSV files
-LoadAssetError loadAssets(const std::string &directory, std::vector<Asset> &assets, const AssetCountType &asset_count_type)
+  // Function to get the subdirectory of the assets of an asset count type
+std::string assetSubdirectory(const AssetCountType &asset_count_type)
 {
-    std::string subdirectory;
-
-      // Determine subdirectory based on option type
     switch (asset_count_type)
     {
     case AssetCountType::Single: 
-        subdirectory = "single_asset";
-        break;
+        return "single_asset";
     case AssetCountType::Multiple: 
-        subdirectory = "multi_asset";
-        break;
+        return "multi_asset";
     default: 
+        return "";
+    }
+}
+
+  // Function to load assets from CSV files
+LoadAssetError loadAssets(const std::string &directory, std::vector<Asset> &assets, const AssetCountType &asset_count_type)
+{
+      // Determine subdirectory based on option type
+    std::string subdirectory = assetSubdirectory(asset_count_type);
+    if (subdirectory.empty())
+    {
         std::cerr << "Invalid option type" << std::endl;
         return LoadAssetError::DirectoryOpenError;
     }
@@ -29,26 +37,81 @@ LoadAssetError loadAssets(const std::string &directory, std::vector<Asset> &asse
 
     try
     {
-        bool validFileFound = false;
+          // Collect the files of the assets in the order of the directory: the CSV path,
+          // and whether the market data file is used instead of it
+        std::vector<std::filesystem::path> csv_paths;
+        std::vector<std::filesystem::path> binary_paths;
+        std::vector<char> use_binary;
 
           // Iterate over each entry in the subdirectory
         for (const auto &entry : std::filesystem::directory_iterator(targetDirectory))
         {
-            if (entry.is_regular_file() && entry.path().extension() == ".csv")
+            if (!entry.is_regular_file())
+                continue;
+
+            std::filesystem::path csv_path    = entry.path();
+            std::filesystem::path binary_path = entry.path();
+            bool is_csv    = entry.path().extension() == ".csv";
+            bool is_binary = entry.path().extension() == MARKET_DATA_EXTENSION;
+            if (is_csv)
+                binary_path.replace_extension(MARKET_DATA_EXTENSION);
+            else if (is_binary)
+                csv_path.replace_extension(".csv");
+            else
+                continue;
+
+              // A market data file next to its CSV file is loaded from the CSV entry
+            if (is_binary && std::filesystem::exists(csv_path))
+                continue;
+
+              // Prefer the market data file unless the CSV file has been modified since the conversion
+            bool binary = is_binary
+                          || (std::filesystem::exists(binary_path)
+                              && std::filesystem::last_write_time(binary_path) >= std::filesystem::last_write_time(csv_path));
+            csv_paths.emplace_back(is_binary ? std::filesystem::path() : csv_path);
+            binary_paths.emplace_back(binary_path);
+            use_binary.emplace_back(binary);
+        }
+
+        bool validFileFound = !csv_paths.empty();
+
+          // Load the files in parallel, every file into its own slot
+        size_t first_asset = assets.size();
+        size_t num_files   = csv_paths.size();
+        assets.resize(first_asset + num_files);
+        std::vector<char> failed(num_files, 0);
+
+#pragma omp parallel for schedule(dynamic)
+        for (size_t f = 0; f < num_files; ++f)
+        {
+            Asset &asset = assets[first_asset + f];
+            asset.setName(binary_paths[f].stem().string());
+
+            if (use_binary[f])
             {
-                validFileFound = true;
-                Asset asset;
-                std::string filename = entry.path().stem().string();
-                asset.setName(filename);
-                int csv_result = extrapolateCsvData(entry.path().string(), &asset);
+                if (loadMarketData(binary_paths[f].string(), &asset) == MarketDataError::Success)
+                    continue;
 
-                if (csv_result == -1)
+                  // Fall back to the CSV file, if there is one
+                if (csv_paths[f].empty())
                 {
-                    std::cout << "Error reading the file " << filename << std::endl;
-                    return LoadAssetError::FileReadError;
+                    failed[f] = 1;
+                    continue;
                 }
+            }
 
-                assets.emplace_back(asset);
+            if (extrapolateCsvData(csv_paths[f].string(), &asset) == -1)
+                failed[f] = 1;
+        }
+
+          // Report the first failure in the order of the directory
+        for (size_t f = 0; f < num_files; ++f)
+        {
+            if (failed[f])
+            {
+                std::cout << "Error reading the file " << binary_paths[f].stem().string() << std::endl;
+                assets.resize(first_asset);
+                return LoadAssetError::FileReadError;
             }
         }
 
@@ -65,74 +128,131 @@ LoadAssetError loadAssets(const std::string &directory, std::vector<Asset> &asse
 
     return LoadAssetError::Success;
 }
-  // Function to extrapolate data from a CSV file
-int extrapolateCsvData(const std::string &filename,
-                       Asset *asset_ptr)
+
+  // Function to load a book of option contracts from a CSV file
+LoadBookError loadOptionBook(const std::string &filename, double at_the_money_strike, std::vector<OptionContract> &contracts)
 {
     std::ifstream file(filename);
     if (!file.is_open())
     {
-        return -1;
+        std::cerr << "Could not open the file " << filename << std::endl;
+        return LoadBookError::FileOpenError;
     }
 
     std::string line;
       // Skip the header line
     std::getline(file, line);
 
-    double total_return_percentage = 0.0;
-    size_t counter                 = 0;
-    double std_dev                 = 0.0;
-    double closing_price           = 0.0;
-    std::vector<double> daily_returns;
-
-      // Process each line of the file
+    size_t line_number = 1;
     while (std::getline(file, line))
     {
+        ++line_number;
+        if (line.empty() || line == "\r")
+            continue;
+
         std::stringstream ss(line);
-        std::string trash;       // Variable to store unused fields
-        std::string temp_open;   // Variable to store the open price
-        std::string temp_close;  // Variable to store the close price
-
-          // Extract and discard date
-        std::getline(ss, trash, ',');
-
-          // Extract and store the open price
-        std::getline(ss, temp_open, ',');
-
-          // Extract and discard high and low prices
-        std::getline(ss, trash, ',');
-        std::getline(ss, trash, ',');
-
-          // Extract and store the close price
-        std::getline(ss, temp_close, ',');
-        closing_price = std::stod(temp_close);
-          // daily_returns.emplace_back((std::stod(temp_close) - std::stod(temp_open)) / std::stod(temp_open));
-        daily_returns.emplace_back(logReturn(std::stod(temp_close), std::stod(temp_open)));
-        total_return_percentage += daily_returns[counter];
-        counter++;
+        std::string temp_multiple;  // Variable to store the strike multiple
+        std::string temp_type;      // Variable to store the option type
+        std::string temp_payoff;    // Variable to store the payoff
+
+        std::getline(ss, temp_multiple, ',');
+        std::getline(ss, temp_type, ',');
+        std::getline(ss, temp_payoff, ',');
+        if (!temp_payoff.empty() && temp_payoff.back() == '\r')
+            temp_payoff.pop_back();
+
+        OptionContract contract;
+        try
+        {
+            contract.strike_price = std::stod(temp_multiple) * at_the_money_strike;
+        }
+        catch (const std::exception &)
+        {
+            std::cerr << "Invalid strike multiple at line " << line_number << " of " << filename << std::endl;
+            return LoadBookError::InvalidLine;
+        }
+
+        if (temp_type == "European")
+            contract.option_type = OptionType::European;
+        else if (temp_type == "Asian")
+            contract.option_type = OptionType::Asian;
+        else
+        {
+            std::cerr << "Invalid option type at line " << line_number << " of " << filename << std::endl;
+            return LoadBookError::InvalidLine;
+        }
+
+        if (temp_payoff == "Call")
+            contract.payoff_type = PayoffType::Call;
+        else if (temp_payoff == "Put")
+            contract.payoff_type = PayoffType::Put;
+        else
+        {
+            std::cerr << "Invalid payoff at line " << line_number << " of " << filename << std::endl;
+            return LoadBookError::InvalidLine;
+        }
+
+        contracts.emplace_back(contract);
     }
 
-      // Close the file
-    file.close();
+    if (contracts.empty())
+        return LoadBookError::NoContracts;
 
-      // Calculate the mean return
-    double return_mean_percentage = total_return_percentage / static_cast<double>(counter);
+    return LoadBookError::Success;
+}
 
-      // Calculate variance
-    for (size_t i = 0; i < counter; i++)
+  // Function to extrapolate data from a CSV file
+int extrapolateCsvData(const std::string &filename,
+                       Asset *asset_ptr)
+{
+    MappedFile file;
+    if (!file.openRead(filename))
     {
-        std_dev += (daily_returns[i] - return_mean_percentage) * (daily_returns[i] - return_mean_percentage) / static_cast<double>(counter);
+        return -1;
+    }
+
+    const char *cursor = reinterpret_cast<const char *>(file.data());
+    const char *end    = cursor + file.size();
+
+      // Skip the header line
+    skipCsvLine(cursor, end);
+
+    double closing_price = 0.0;
+    std::vector<double> daily_returns;
+    daily_returns.reserve(static_cast<size_t>(end - cursor) / 48 + 1);
+    RunningStatistics statistics;
+
+      // Process each line of the file
+    while (cursor < end)
+    {
+          // Skip the empty lines
+        if (*cursor == '\n' || *cursor == '\r')
+        {
+            ++cursor;
+            continue;
+        }
+
+        std::string_view date;
+        double open_price  = 0.0;
+        double close_price = 0.0;
+
+          // The date is not needed, the parser is the one of the market data files
+        if (!parseCsvPriceLine(cursor, end, date, open_price, close_price))
+            return -1;
+
+        closing_price = close_price;
+        daily_returns.emplace_back(logReturn(close_price, open_price));
+        statistics.add(daily_returns.back());
     }
-    std_dev = std::sqrt(std_dev);
 
       // Update the Asset object with the accumulated values
     if (asset_ptr)
     {
-        asset_ptr->setReturnMean(return_mean_percentage);
-        asset_ptr->setReturnStdDev(std_dev);
+        asset_ptr->setReturnMean(statistics.getMean());
+        asset_ptr->setReturnStdDev(std::sqrt(statistics.getVariance()));
         asset_ptr->setLastRealValue(closing_price);
-        asset_ptr->setDailyReturns(daily_returns);
+        asset_ptr->setDailyReturns(std::move(daily_returns));
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,79 @@
+#include "../../include/optionpricing/finance_mappedfile.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+  // Function to map an existing file for reading
+bool MappedFile::openRead(const std::string &filename)
+{
+    close();
+
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return false;
+
+    struct stat file_status;
+    if (fstat(descriptor, &file_status) != 0 || file_status.st_size <= 0)
+    {
+        ::close(descriptor);
+        return false;
+    }
+
+    size_t file_size = static_cast<size_t>(file_status.st_size);
+    void *address    = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+      // The mapping stays valid after the descriptor is closed
+    ::close(descriptor);
+    if (address == MAP_FAILED)
+        return false;
+
+      // The files are scanned from the start to the end
+    madvise(address, file_size, MADV_SEQUENTIAL);
+
+    mapping = static_cast<unsigned char *>(address);
+    length  = file_size;
+    return true;
+}
+
+  // Function to create a file of a given size and map it for writing
+bool MappedFile::create(const std::string &filename, size_t size)
+{
+    close();
+    if (size == 0)
+        return false;
+
+    int descriptor = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0)
+        return false;
+
+    if (ftruncate(descriptor, static_cast<off_t>(size)) != 0)
+    {
+        ::close(descriptor);
+        return false;
+    }
+
+    void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (address == MAP_FAILED)
+        return false;
+
+    mapping = static_cast<unsigned char *>(address);
+    length  = size;
+    return true;
+}
+
+  // Function to release the mapping
+void MappedFile::close()
+{
+    if (mapping)
+        munmap(mapping, length);
+
+    mapping = nullptr;
+    length  = 0;
+}
@@ -0,0 +1,213 @@
+#include "../../include/optionpricing/finance_marketdata.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <charconv>
+#include <iostream>
+
+  // Function to get the offset of a column of a market data file
+size_t marketDataColumnOffset(size_t column, size_t num_rows)
+{
+    auto align = [](size_t offset) { return (offset + MARKET_DATA_ALIGNMENT - 1) / MARKET_DATA_ALIGNMENT * MARKET_DATA_ALIGNMENT; };
+
+      // The dates are int32, the other columns doubles
+    size_t offset = align(sizeof(MarketDataHeader));
+    if (column == 0)
+        return offset;
+
+    offset = align(offset + num_rows * sizeof(int32_t));
+    return offset + (column - 1) * align(num_rows * sizeof(double));
+}
+
+  // Function to calculate the mean and the standard deviation of the daily log returns
+void calculateReturnStatistics(const std::vector<double> &daily_returns, double &return_mean, double &return_std_dev)
+{
+      // Same Welford updates as the single pass of extrapolateCsvData
+    RunningStatistics statistics;
+    for (double daily_return : daily_returns)
+        statistics.add(daily_return);
+
+    return_mean    = statistics.getMean();
+    return_std_dev = std::sqrt(statistics.getVariance());
+}
+
+  // Function to move a cursor in a CSV file to the start of the next line
+void skipCsvLine(const char *&cursor, const char *end)
+{
+    const char *found = static_cast<const char *>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+    cursor = found ? found + 1 : end;
+}
+
+  // Function to parse the date, the open price and the close price of a line of a CSV file
+bool parseCsvPriceLine(const char *&cursor, const char *end, std::string_view &date, double &open_price, double &close_price)
+{
+    const char *position = cursor;
+
+      // Move the position after the next comma of the line
+    auto skipField = [&]()
+    {
+        while (position != end && *position != ',' && *position != '\n')
+            ++position;
+        if (position == end || *position != ',')
+            return false;
+        ++position;
+        return true;
+    };
+
+      // Parse a number at the position and move after the following comma, the last field
+      // of a line may also end with the line or with the file
+    auto parseField = [&](double &value, bool last_field)
+    {
+        std::from_chars_result result = std::from_chars(position, end, value);
+        if (result.ec != std::errc())
+            return false;
+        if (result.ptr != end && *result.ptr == ',')
+        {
+            position = result.ptr + 1;
+            return true;
+        }
+        if (!last_field || (result.ptr != end && *result.ptr != '\r' && *result.ptr != '\n'))
+            return false;
+        position = result.ptr;
+        return true;
+    };
+
+      // The date, the open price, the discarded high and low prices and the close price
+    const char *date_begin = position;
+    if (!skipField())
+        return false;
+    date = std::string_view(date_begin, static_cast<size_t>(position - 1 - date_begin));
+    if (!parseField(open_price, false) || !skipField() || !skipField() || !parseField(close_price, true))
+        return false;
+
+      // Discard the rest of the line
+    cursor = position;
+    skipCsvLine(cursor, end);
+    return true;
+}
+
+  // Function to convert a CSV file of daily prices to a market data file
+MarketDataError convertCsvToMarketData(const std::string &csv_filename, const std::string &filename)
+{
+    MappedFile file;
+    if (!file.openRead(csv_filename))
+    {
+        std::cerr << "Could not open the file " << csv_filename << std::endl;
+        return MarketDataError::FileOpenError;
+    }
+
+    const char *cursor = reinterpret_cast<const char *>(file.data());
+    const char *end    = cursor + file.size();
+
+      // Skip the header line
+    skipCsvLine(cursor, end);
+
+    std::vector<int32_t> dates;
+    std::vector<double> open_prices;
+    std::vector<double> close_prices;
+    std::vector<double> daily_returns;
+
+      // Process each line of the file
+    while (cursor < end)
+    {
+          // Skip the empty lines
+        if (*cursor == '\n' || *cursor == '\r')
+        {
+            ++cursor;
+            continue;
+        }
+
+        std::string_view date_field;
+        double open_price  = 0.0;
+        double close_price = 0.0;
+        bool valid = parseCsvPriceLine(cursor, end, date_field, open_price, close_price);
+
+          // yyyy-mm-dd to yyyymmdd
+        int32_t date = 0;
+        size_t digits = 0;
+        for (char c : date_field)
+        {
+            if (c == '-')
+                continue;
+            if (c < '0' || c > '9' || ++digits > 8)
+            {
+                valid = false;
+                break;
+            }
+            date = 10 * date + (c - '0');
+        }
+
+        if (!valid || digits == 0)
+        {
+            std::cerr << "Invalid line " << dates.size() + 2 << " of " << csv_filename << std::endl;
+            return MarketDataError::InvalidFormat;
+        }
+        dates.emplace_back(date);
+        open_prices.emplace_back(open_price);
+        close_prices.emplace_back(close_price);
+        daily_returns.emplace_back(std::log(close_price / open_price));
+    }
+
+    if (dates.empty())
+    {
+        std::cerr << "No rows in " << csv_filename << std::endl;
+        return MarketDataError::InvalidFormat;
+    }
+
+    MarketDataHeader header;
+    std::memset(&header, 0, sizeof(MarketDataHeader));
+    std::memcpy(header.magic, MARKET_DATA_MAGIC, sizeof(MARKET_DATA_MAGIC));
+    header.version    = MARKET_DATA_VERSION;
+    header.num_rows   = dates.size();
+    header.last_close = close_prices.back();
+    calculateReturnStatistics(daily_returns, header.return_mean, header.return_std_dev);
+
+      // Create the file at its final size and copy the header and the columns
+    size_t num_rows = dates.size();
+    MappedFile output;
+    if (!output.create(filename, marketDataColumnOffset(4, num_rows)))
+    {
+        std::cerr << "Could not create the file " << filename << std::endl;
+        return MarketDataError::FileOpenError;
+    }
+
+    unsigned char *data = output.data();
+    std::memcpy(data, &header, sizeof(MarketDataHeader));
+    std::memcpy(data + marketDataColumnOffset(0, num_rows), dates.data(), num_rows * sizeof(int32_t));
+    std::memcpy(data + marketDataColumnOffset(1, num_rows), open_prices.data(), num_rows * sizeof(double));
+    std::memcpy(data + marketDataColumnOffset(2, num_rows), close_prices.data(), num_rows * sizeof(double));
+    std::memcpy(data + marketDataColumnOffset(3, num_rows), daily_returns.data(), num_rows * sizeof(double));
+
+    return MarketDataError::Success;
+}
+
+  // Function to load an asset from a market data file
+MarketDataError loadMarketData(const std::string &filename, Asset *asset_ptr)
+{
+    MappedFile file;
+    if (!file.openRead(filename))
+        return MarketDataError::FileOpenError;
+
+      // Check the header before reading anything it points to
+    const MarketDataHeader *header = reinterpret_cast<const MarketDataHeader *>(file.data());
+    if (file.size() < sizeof(MarketDataHeader)
+        || std::memcmp(header->magic, MARKET_DATA_MAGIC, sizeof(MARKET_DATA_MAGIC)) != 0
+        || header->version != MARKET_DATA_VERSION
+        || header->num_rows == 0
+        || file.size() < marketDataColumnOffset(4, header->num_rows))
+    {
+        return MarketDataError::InvalidFormat;
+    }
+
+    if (asset_ptr)
+    {
+        const double *returns = reinterpret_cast<const double *>(file.data() + marketDataColumnOffset(3, header->num_rows));
+        asset_ptr->setReturnMean(header->return_mean);
+        asset_ptr->setReturnStdDev(header->return_std_dev);
+        asset_ptr->setLastRealValue(header->last_close);
+        asset_ptr->setDailyReturns(std::vector<double>(returns, returns + header->num_rows));
+    }
+
+    return MarketDataError::Success;
+}
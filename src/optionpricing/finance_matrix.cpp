@@ -0,0 +1,164 @@
+#include "../../include/optionpricing/finance_matrix.hpp"
+
+#include <new>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+  // Function to allocate zeroed storage aligned to MATRIX_ALIGNMENT, the size is rounded up
+  // to a multiple of the alignment as aligned_alloc requires
+static double *allocateAligned(size_t count)
+{
+    size_t bytes = (std::max<size_t>(1, count) * sizeof(double) + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+    double *pointer = static_cast<double *>(std::aligned_alloc(MATRIX_ALIGNMENT, bytes));
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    std::memset(pointer, 0, bytes);
+    return pointer;
+}
+
+  // Constructor: the leading dimension is a whole number of cache lines and of column
+  // multiples, rows 4 KiB apart would fall in the same sets of the L1 cache
+Matrix::Matrix(size_t rows, size_t columns, size_t column_multiple)
+    :  num_rows(rows), num_columns(columns)
+{
+    size_t line     = MATRIX_ALIGNMENT / sizeof(double);
+    size_t multiple = std::max(line, (std::max<size_t>(1, column_multiple) + line - 1) / line * line);
+
+    leading_dimension = (columns + multiple - 1) / multiple * multiple;
+    if (leading_dimension > 0 && (leading_dimension * sizeof(double)) % 4096 == 0)
+        leading_dimension += multiple;
+
+    values.reset(allocateAligned(num_rows * leading_dimension));
+}
+
+Matrix::Matrix(const Matrix &other)
+    :  num_rows(other.num_rows), num_columns(other.num_columns), leading_dimension(other.leading_dimension)
+{
+    if (other.values)
+    {
+        values.reset(allocateAligned(num_rows * leading_dimension));
+        std::memcpy(values.get(), other.values.get(), num_rows * leading_dimension * sizeof(double));
+    }
+}
+
+Matrix &Matrix::operator=(const Matrix &other)
+{
+    if (this != &other)
+        *this = Matrix(other);
+    return *this;
+}
+
+  // Constructor of a triangle of zeros
+PackedLowerMatrix::PackedLowerMatrix(size_t size)
+    :  num_rows(size), values(allocateAligned(size * (size + 1) / 2))
+{
+}
+
+  // Constructor: pack the lower triangle of the matrix row by row, scaled
+PackedLowerMatrix::PackedLowerMatrix(const Matrix &lower, double scale)
+    :  PackedLowerMatrix(lower.rows())
+{
+    for (size_t i = 0; i < num_rows; ++i)
+    {
+        const double *source = lower.row(i);
+        double *destination  = row(i);
+#pragma omp simd
+        for (size_t k = 0; k <= i; ++k)
+            destination[k] = scale * source[k];
+    }
+}
+
+PackedLowerMatrix::PackedLowerMatrix(const PackedLowerMatrix &other)
+    :  num_rows(other.num_rows)
+{
+    if (other.values)
+    {
+        size_t count = num_rows * (num_rows + 1) / 2;
+        values.reset(allocateAligned(count));
+        std::memcpy(values.get(), other.values.get(), count * sizeof(double));
+    }
+}
+
+PackedLowerMatrix &PackedLowerMatrix::operator=(const PackedLowerMatrix &other)
+{
+    if (this != &other)
+        *this = PackedLowerMatrix(other);
+    return *this;
+}
+
+  // Function to compute y = A x, one dot product per row
+void matrixVectorProduct(const Matrix &A, const double *x, double *y)
+{
+    size_t columns = A.columns();
+    for (size_t i = 0; i < A.rows(); ++i)
+    {
+        const double *a = A.row(i);
+        double sum      = 0.0;
+#pragma omp simd reduction(+ : sum)
+        for (size_t k = 0; k < columns; ++k)
+            sum += a[k] * x[k];
+        y[i] = sum;
+    }
+}
+
+  // Function to compute y = L x, one dot product per row up to the diagonal
+void lowerMatrixVectorProduct(const Matrix &L, const double *x, double *y)
+{
+    for (size_t i = 0; i < L.rows(); ++i)
+    {
+        const double *l = L.row(i);
+        double sum      = 0.0;
+#pragma omp simd reduction(+ : sum)
+        for (size_t k = 0; k <= i; ++k)
+            sum += l[k] * x[k];
+        y[i] = sum;
+    }
+}
+
+  // Function to compute y = L^T x, one scaled row of L added per entry of x
+void lowerTransposeVectorProduct(const Matrix &L, const double *x, double *y)
+{
+    size_t n = L.rows();
+    std::fill(y, y + n, 0.0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double *l = L.row(i);
+        double weight   = x[i];
+#pragma omp simd
+        for (size_t k = 0; k <= i; ++k)
+            y[k] += weight * l[k];
+    }
+}
+
+  // Function to solve L x = b by forward substitution
+void lowerSolve(const Matrix &L, const double *b, double *x)
+{
+    for (size_t i = 0; i < L.rows(); ++i)
+    {
+        const double *l = L.row(i);
+        double sum      = 0.0;
+#pragma omp simd reduction(+ : sum)
+        for (size_t k = 0; k < i; ++k)
+            sum += l[k] * x[k];
+        x[i] = (b[i] - sum) / l[i];
+    }
+}
+
+  // Function to solve L^T x = b by back substitution, the solved entries are removed
+  // from the right-hand side with the rows of L
+void lowerTransposeSolve(const Matrix &L, const double *b, double *x)
+{
+    size_t n = L.rows();
+    if (x != b)
+        std::copy(b, b + n, x);
+    for (size_t i = n; i-- > 0;)
+    {
+        const double *l = L.row(i);
+        double value    = x[i] / l[i];
+        x[i]            = value;
+#pragma omp simd
+        for (size_t k = 0; k < i; ++k)
+            x[k] -= value * l[k];
+    }
+}
@@ -1,215 +1,939 @@
 #include "../../include/optionpricing/finance_montecarlo.hpp"
+#include "../../include/optionpricing/finance_pricingutils.hpp"
 
-  // Function to calculate the option price prediction using the Monte Carlo method
-  // The function is the core of the finance oriented project, which is used to predict
-  // the option price prediction using the Monte Carlo method.
-std::pair<double, double> monteCarloPricePrediction(size_t points,
-                                                    const std::vector<const Asset *> &assetPtrs,
-                                                    double &variance,
-                                                    const double strike_price,
-                                                    std::vector<double> &predicted_assets_prices,
-                                                    const OptionType &option_type,
-                                                    MonteCarloError &error)
+  // Function to compute the weights of the geometric basket, the shares of the initial
+  // prices, so that B_0 * prod_i (S_i / S_i(0))^w_i matches the basket to first order
+template <typename Real>
+static std::vector<double> geometricWeights(const std::vector<Real> &initial_prices)
 {
-    double C                   = 0.0;
-    double C0                  = 0.0;
-    double total_value         = 0.0;
-    double total_squared_value = 0.0;
-    double result1             = 0.0;
-    double result2             = 0.0;
-    double r                   = 0.05;
-    double T                   = 1.0;
-      // Number of days to simulate (1 day for European option, 252 days for Asian option
-    uint num_days_to_simulate = 1;
-    if (option_type == OptionType::Asian)
+    double basket = 0.0;
+    for (Real price : initial_prices)
+        basket += static_cast<double>(price);
+
+    std::vector<double> weights(initial_prices.size());
+    for (size_t i = 0; i < initial_prices.size(); ++i)
+        weights[i] = static_cast<double>(initial_prices[i]) / basket;
+    return weights;
+}
+
+  // Function to compute the mean of the logarithm of the geometric basket of the time
+  // averages, log B_0 + sum_i w_i (log S_i - log S_i(0)) averaged over the steps 1..num_steps
+template <typename Real>
+static double geometricLogMean(const std::vector<Real> &initial_prices, const std::vector<Real> &drifts, size_t num_steps)
+{
+    std::vector<double> weights = geometricWeights(initial_prices);
+    double log_mean = 0.0;
+    double basket   = 0.0;
+    for (size_t i = 0; i < initial_prices.size(); ++i)
     {
-        num_days_to_simulate = 252;
+        log_mean += weights[i] * 0.5 * (static_cast<double>(num_steps) + 1.0) * static_cast<double>(drifts[i]);
+        basket   += static_cast<double>(initial_prices[i]);
     }
+    return std::log(basket) + log_mean;
+}
 
-      // Start the timer
-    auto start = std::chrono::high_resolution_clock::now();
+  // Function to compute the expectation of the control variate of the pairs, under the
+  // simulated model: log S_i(s) = log S_i(0) + s * drift_i + level_i(s), where level is a
+  // Brownian motion with covariance dt * C, C = A A^T. For the Asian options the control
+  // is the call on the geometric basket of the time averages, which is lognormal; for the
+  // European ones it is the discounted final basket
+template <typename Real>
+static double controlVariateMean(const std::vector<Real> &initial_prices,
+                                 const std::vector<Real> &drifts,
+                                 const Matrix &A,
+                                 double dt,
+                                 double discount,
+                                 double strike_price,
+                                 size_t num_steps,
+                                 bool average)
+{
+    double n = static_cast<double>(num_steps);
 
-      // Calculate the covariance matrix
-    CovarianceError cov_error;
-    std::vector<std::vector<double>> covariance_matrix = calculateCovarianceMatrix(assetPtrs, cov_error);
+    if (!average)
+    {
+        double mean = 0.0;
+        for (size_t i = 0; i < initial_prices.size(); ++i)
+        {
+            const double *a = A.row(i);
+            double variance = 0.0;
+            for (size_t k = 0; k <= i; ++k)
+                variance += a[k] * a[k];
+            mean += static_cast<double>(initial_prices[i]) * std::exp(n * static_cast<double>(drifts[i]) + 0.5 * n * dt * variance);
+        }
+        return discount * mean;
+    }
+
+      // Mean and variance of the logarithm of the geometric basket, w^T C w = |A^T w|^2
+    std::vector<double> weights = geometricWeights(initial_prices);
+    double log_mean = geometricLogMean(initial_prices, drifts, num_steps);
+
+    std::vector<double> projection(A.rows());
+    lowerTransposeVectorProduct(A, weights.data(), projection.data());
+
+    double weighted_variance = 0.0;
+    for (double column : projection)
+        weighted_variance += column * column;
+    double log_variance = dt * weighted_variance * (n + 1.0) * (2.0 * n + 1.0) / (6.0 * n);
+
+      // Black formula on the lognormal geometric basket
+    double deviation = std::sqrt(log_variance);
+    double d2 = (log_mean - std::log(strike_price)) / deviation;
+    double d1 = d2 + deviation;
+    return discount * (std::exp(log_mean + 0.5 * log_variance) * phi(d1) - strike_price * phi(d2));
+}
 
-      // Check if the covariance matrix was calculated successfully
-    if (cov_error != CovarianceError::Success)
+  // Function to compute the inverse of the covariance matrix C = A A^T from its
+  // Cholesky factor, C^-1 = A^-T A^-1
+static Matrix inverseCovariance(const Matrix &A)
+{
+    size_t n = A.rows();
+
+      // The row k holds the column k of A^-1
+    Matrix columns(n, n);
+    for (size_t k = 0; k < n; ++k)
     {
-        std::cerr << "Error calculating the covariance matrix" << std::endl;
-        return std::make_pair(0.0, 0.0);
+        double *column = columns.row(k);
+        column[k]      = 1.0;
+        lowerSolve(A, column, column);
     }
 
-      // Calculate the Cholesky factorization of the covariance matrix
-    std::vector<std::vector<double>> A = choleskyFactorization(covariance_matrix, 1.0);
+    Matrix inverse(n, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double *column_i = columns.row(i);
+        for (size_t j = 0; j <= i; ++j)
+        {
+            const double *column_j = columns.row(j);
+            double sum = 0.0;
+#pragma omp simd reduction(+ : sum)
+            for (size_t k = 0; k < n; ++k)
+                sum += column_i[k] * column_j[k];
+            inverse(i, j) = sum;
+            inverse(j, i) = sum;
+        }
+    }
+    return inverse;
+}
+
+  // Constants of the Greeks of a call: the volatility of the drift and the scale and
+  // shift of the diffusion of every asset, and the inverse covariance of the first step
+struct GreekConstants
+{
+    std::vector<double> initial_prices;
+    std::vector<double> sigmas;
+    std::vector<double> diffusion_scales;
+    std::vector<double> diffusion_shifts;
+    Matrix inverse_covariance;
+    double dt;
+    double T;
+    double discount;
+    double strike_price;
+    size_t num_steps;
+    bool average;
+};
+
+  // Buffers of the Greek samples of a block of pairs, one set per thread
+struct GreekBuffers
+{
+    std::vector<double> exercise1, exercise2;
+    std::vector<double> score1, score2;
+    std::vector<double> delta, gamma, vega, rho;
+
+    explicit GreekBuffers(size_t num_assets)
+        :  exercise1(PATHS_PER_BLOCK), exercise2(PATHS_PER_BLOCK), score1(num_assets * PATHS_PER_BLOCK), score2(num_assets * PATHS_PER_BLOCK),
+           delta(PATHS_PER_BLOCK), gamma(PATHS_PER_BLOCK), vega(PATHS_PER_BLOCK), rho(PATHS_PER_BLOCK) {}
+};
+
+  // Function to add the Greek samples of a block of pairs to the statistics. With the basket B
+  // in the exercise region, the pathwise derivative of the discounted payoff is the derivative
+  // of B: B_i / S_i(0) for the delta of the asset i, sum_s S_i(s) (-sigma_i s dt + W_i(s)) / n
+  // for the vega, with W_i the Brownian motion of the asset in units of volatility, and
+  // sum_s S_i(s) s dt / n - T payoff for the rho. The gamma multiplies the pathwise delta
+  // by the score of the first step, (C^-1 x)_i / dt - 1 over S_i(0), with x the centred
+  // increment of the logarithms of the prices. Every path is weighted by its likelihood ratio
+template <typename Real>
+static void addGreekSamples(const GreekConstants &constants,
+                            const std::vector<PathBlockState<Real>> &states,
+                            const Real *first_increments,
+                            const Real *basket1,
+                            const Real *basket2,
+                            const Real *ratio1,
+                            const Real *ratio2,
+                            const Real *pair_values,
+                            size_t count,
+                            GreekBuffers &buffers,
+                            GreekStatistics &greeks)
+{
+    size_t num_assets = states.size();
+    double n          = static_cast<double>(constants.num_steps);
+    double scale      = 0.5 * constants.discount;
+    Real   strike     = static_cast<Real>(constants.strike_price);
+    double *exercise1 = buffers.exercise1.data(), *exercise2 = buffers.exercise2.data();
+    double *delta = buffers.delta.data(), *gamma = buffers.gamma.data();
+    double *vega  = buffers.vega.data(), *rho = buffers.rho.data();
 
-      // Check if the matrix is positive-definite
-    if (A.empty())
+      // Likelihood ratios of the paths in the exercise region, times the scale of the pairs
+#pragma omp simd
+    for (size_t p = 0; p < count; ++p)
     {
-        std::cerr << "Matrix is not positive-definite" << std::endl;
-        return std::make_pair(0.0, 0.0);
+        exercise1[p] = basket1[p] > strike ? scale * static_cast<double>(ratio1[p]) : 0.0;
+        exercise2[p] = basket2[p] > strike ? scale * static_cast<double>(ratio2[p]) : 0.0;
+        vega[p]      = 0.0;
+        rho[p]       = 0.0;
+    }
+
+      // Scores of the first step of the paths and of their mirrors, C^-1 x / dt
+    double inverse_dt = 1.0 / constants.dt;
+    for (size_t i = 0; i < num_assets; ++i)
+    {
+        double *score1 = &buffers.score1[i * PATHS_PER_BLOCK];
+        double *score2 = &buffers.score2[i * PATHS_PER_BLOCK];
+        std::fill(score1, score1 + count, 0.0);
+        std::fill(score2, score2 + count, 0.0);
+        for (size_t k = 0; k < num_assets; ++k)
+        {
+            double weight    = constants.inverse_covariance(i, k) * inverse_dt;
+            double shift     = constants.diffusion_shifts[k];
+            const Real *increment = &first_increments[k * PATHS_PER_BLOCK];
+#pragma omp simd
+            for (size_t p = 0; p < count; ++p)
+            {
+                score1[p] += weight * (shift + static_cast<double>(increment[p]));
+                score2[p] += weight * (shift - static_cast<double>(increment[p]));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < num_assets; ++i)
+    {
+        const PathBlockState<Real> &state = states[i];
+        const double *score1 = &buffers.score1[i * PATHS_PER_BLOCK];
+        const double *score2 = &buffers.score2[i * PATHS_PER_BLOCK];
+        double inverse_initial = 1.0 / constants.initial_prices[i];
+        double drift   = -constants.sigmas[i] * constants.dt;
+        double shift   = constants.diffusion_shifts[i];
+        double inverse = 1.0 / constants.diffusion_scales[i];
+
+        if (constants.average)
+        {
+            double inverse_steps = 1.0 / n;
+#pragma omp simd
+            for (size_t p = 0; p < count; ++p)
+            {
+                double time1  = static_cast<double>(state.time_price1[p]);
+                double time2  = static_cast<double>(state.time_price2[p]);
+                double value1 = static_cast<double>(state.sum1[p]) * inverse_steps;
+                double value2 = static_cast<double>(state.sum2[p]) * inverse_steps;
+                double volatility1 = drift * time1 + (static_cast<double>(state.level_price1[p]) + shift * time1) * inverse;
+                double volatility2 = drift * time2 + (static_cast<double>(state.level_price2[p]) + shift * time2) * inverse;
+
+                delta[p] = (exercise1[p] * value1 + exercise2[p] * value2) * inverse_initial;
+                gamma[p] = (exercise1[p] * value1 * (score1[p] - 1.0) + exercise2[p] * value2 * (score2[p] - 1.0)) * inverse_initial * inverse_initial;
+                vega[p] += (exercise1[p] * volatility1 + exercise2[p] * volatility2) * inverse_steps;
+                rho[p]  += (exercise1[p] * time1 + exercise2[p] * time2) * constants.dt * inverse_steps;
+            }
+        }
+        else
+        {
+#pragma omp simd
+            for (size_t p = 0; p < count; ++p)
+            {
+                double value1 = static_cast<double>(state.price1[p]);
+                double value2 = static_cast<double>(state.price2[p]);
+                double level  = static_cast<double>(state.level[p]);
+                double volatility1 = value1 * (drift * n + (level + n * shift) * inverse);
+                double volatility2 = value2 * (drift * n + (n * shift - level) * inverse);
+
+                delta[p] = (exercise1[p] * value1 + exercise2[p] * value2) * inverse_initial;
+                gamma[p] = (exercise1[p] * value1 * (score1[p] - 1.0) + exercise2[p] * value2 * (score2[p] - 1.0)) * inverse_initial * inverse_initial;
+                vega[p] += exercise1[p] * volatility1 + exercise2[p] * volatility2;
+                rho[p]  += (exercise1[p] * value1 + exercise2[p] * value2) * constants.dt * n;
+            }
+        }
+
+        greeks.delta[i].addBlock(delta, count);
+        greeks.gamma[i].addBlock(gamma, count);
     }
 
-      // Zeta matrix
-    std::vector<std::vector<double>> zeta_matrix(num_days_to_simulate, std::vector<double>(assetPtrs.size(), 0.0));
-    fillZetaMatrix(zeta_matrix);
+      // The discount factor also depends on the rate
+#pragma omp simd
+    for (size_t p = 0; p < count; ++p)
+        rho[p] -= constants.T * static_cast<double>(pair_values[p]);
+
+    greeks.vega.addBlock(vega, count);
+    greeks.rho.addBlock(rho, count);
+}
+
+  // Function to choose the shift mu of the driving normals of the importance sampling
+  // with the cross-entropy method: every iteration simulates PILOT_PAIRS pairs under
+  // the current shift, sets the level to the strike or, if fewer than the elite
+  // fraction of the paths reach it, to the quantile of the baskets at that fraction,
+  // and moves mu to the mean of the normals weighted by the likelihood ratio times
+  // the payoff at that level. reached tells whether the last level is the strike,
+  // otherwise the shift does not lead the paths into the exercise region
+template <typename Real>
+static std::vector<double> importanceSamplingShift(const std::vector<Real> &initial_prices,
+                                                   const std::vector<Real> &drifts,
+                                                   const Matrix &A,
+                                                   const CorrelatedShocks<Real> &shocks,
+                                                   double dt,
+                                                   double strike_price,
+                                                   bool average,
+                                                   uint64_t seed,
+                                                   size_t num_days_to_simulate,
+                                                   bool &reached)
+{
+    size_t num_assets = initial_prices.size();
+    size_t paths      = 2 * PILOT_PAIRS;
+    double n          = static_cast<double>(num_days_to_simulate);
+    double sqrt_dt    = std::sqrt(dt);
+
+    std::vector<double> shift(num_assets, 0.0);
+    std::vector<double> baskets(paths);
+    std::vector<double> log_ratios(paths);
+    std::vector<double> normal_sums(paths * num_assets);
+    std::vector<PathBlockState<Real>> states(num_assets);
+    std::vector<Real> normals, increments;
+    std::vector<Real> basket1(PATHS_PER_BLOCK), basket2(PATHS_PER_BLOCK), level_sum(PATHS_PER_BLOCK);
+    std::vector<Real> shifted_drifts(num_assets);
+    reached = false;
+
+    for (size_t iteration = 0; iteration < PILOT_ITERATIONS; ++iteration)
+    {
+          // The shift enters the drift, the paths are mirrored around it
+        std::vector<double> drift_shift(num_assets);
+        lowerMatrixVectorProduct(A, shift.data(), drift_shift.data());
+        double shift_norm = 0.0;
+        for (size_t i = 0; i < num_assets; ++i)
+        {
+            drift_shift[i]   *= sqrt_dt;
+            shifted_drifts[i] = static_cast<Real>(static_cast<double>(drifts[i]) + drift_shift[i]);
+            shift_norm += shift[i] * shift[i];
+        }
+
+          // Pilot paths from streams after the ones of the pricing
+        for (size_t b = 0; b < PILOT_PAIRS / PATHS_PER_BLOCK; ++b)
+        {
+            RandomStream stream(seed, (1ULL << 62) + iteration * PILOT_PAIRS + b);
+            std::fill(basket1.begin(), basket1.end(), Real(0));
+            std::fill(basket2.begin(), basket2.end(), Real(0));
+            for (size_t i = 0; i < num_assets; ++i)
+                resetPathBlock(states[i], initial_prices[i]);
+
+            for (size_t first_step = 0; first_step < num_days_to_simulate; first_step += STEPS_PER_TILE)
+            {
+                size_t num_steps = std::min<size_t>(STEPS_PER_TILE, num_days_to_simulate - first_step);
+                shocks.generate(stream, num_steps, PATHS_PER_BLOCK, normals, increments);
+                for (size_t i = 0; i < num_assets; ++i)
+                    advancePathBlock(states[i], &increments[i * num_steps * PATHS_PER_BLOCK], num_steps, PATHS_PER_BLOCK, shifted_drifts[i]);
+            }
+            for (size_t i = 0; i < num_assets; ++i)
+                finishPathBlock(states[i], num_days_to_simulate, PATHS_PER_BLOCK, average, Real(0), basket1.data(), basket2.data(), level_sum.data());
+
+              // Sums of the unshifted normals of every factor, sum_s z_s = L^-1 level / sqrt(dt)
+            std::vector<double> sums(num_assets);
+            for (size_t p = 0; p < PATHS_PER_BLOCK; ++p)
+            {
+                for (size_t i = 0; i < num_assets; ++i)
+                    sums[i] = static_cast<double>(states[i].level[p]) / sqrt_dt;
+                lowerSolve(A, sums.data(), sums.data());
+
+                double projection = 0.0;
+                for (size_t k = 0; k < num_assets; ++k)
+                    projection += shift[k] * sums[k];
+
+                size_t path = 2 * (b * PATHS_PER_BLOCK + p);
+                baskets[path]        = static_cast<double>(basket1[p]);
+                baskets[path + 1]    = static_cast<double>(basket2[p]);
+                log_ratios[path]     = -projection - 0.5 * n * shift_norm;
+                log_ratios[path + 1] =  projection - 0.5 * n * shift_norm;
+                for (size_t k = 0; k < num_assets; ++k)
+                {
+                    normal_sums[path * num_assets + k]       = n * shift[k] + sums[k];
+                    normal_sums[(path + 1) * num_assets + k] = n * shift[k] - sums[k];
+                }
+            }
+        }
+
+          // Level of the iteration: the strike, or the quantile of the elite fraction
+        std::vector<double> sorted = baskets;
+        size_t elite = static_cast<size_t>((1.0 - PILOT_ELITE_FRACTION) * static_cast<double>(paths));
+        std::nth_element(sorted.begin(), sorted.begin() + elite, sorted.end());
+        double level = std::min(strike_price, sorted[elite]);
+
+          // Weighted mean of the normals per step
+        double total = 0.0;
+        std::vector<double> next(num_assets, 0.0);
+        for (size_t path = 0; path < paths; ++path)
+        {
+            double weight = std::max(0.0, baskets[path] - level) * std::exp(log_ratios[path]);
+            total += weight;
+            for (size_t k = 0; k < num_assets; ++k)
+                next[k] += weight * normal_sums[path * num_assets + k];
+        }
+        if (total <= 0.0)
+            break;
+        for (size_t k = 0; k < num_assets; ++k)
+            shift[k] = next[k] / (total * n);
+
+        if (level >= strike_price)
+        {
+            reached = true;
+            break;
+        }
+    }
+
+    return shift;
+}
+
+  // Function to merge the statistics of the Greeks of other into greeks, or to add
+  // only their means as one sample each when means_only is true
+static void mergeGreekStatistics(GreekStatistics &greeks, const GreekStatistics &other, bool means_only = false)
+{
+    greeks.delta.resize(other.delta.size());
+    greeks.gamma.resize(other.gamma.size());
+    for (size_t i = 0; i < other.delta.size(); ++i)
+    {
+        if (means_only)
+        {
+            greeks.delta[i].add(other.delta[i].getMean());
+            greeks.gamma[i].add(other.gamma[i].getMean());
+        }
+        else
+        {
+            greeks.delta[i].merge(other.delta[i]);
+            greeks.gamma[i].merge(other.gamma[i]);
+        }
+    }
+
+    if (means_only)
+    {
+        greeks.vega.add(other.vega.getMean());
+        greeks.rho.add(other.rho.getMean());
+    }
+    else
+    {
+        greeks.vega.merge(other.vega);
+        greeks.rho.merge(other.rho);
+    }
+}
+
+  // Function to simulate the antithetic pairs of paths block by block in the
+  // precision Real and to merge the discounted payoffs and their control variates
+  // into the statistics. With a sequence, the pair of index k is built by Brownian
+  // bridges from its point k. With the importance sampling, the paths are tilted by
+  // shift, chosen by the pilot if it is empty, and the payoffs and the controls are
+  // weighted by the likelihood ratios. With greeks, the samples of the
+  // Greeks are added to it. Returns the expectation of the control variate
+template <typename Real>
+static double pricePathBlocks(size_t pairs,
+                              const std::vector<const Asset *> &assetPtrs,
+                              RunningCovariance &statistics,
+                              const double strike_price,
+                              std::vector<double> &predicted_assets_prices,
+                              const OptionType &option_type,
+                              const Matrix &A,
+                              const QmcSequence *sequence,
+                              bool importance_sampling,
+                              std::vector<double> &shift,
+                              GreekStatistics *greeks,
+                              uint64_t seed,
+                              const uint num_days_to_simulate)
+{
+    double r        = 0.05;
+    double T        = 1.0;
+    double dt       = T / num_days_to_simulate;
+    double discount = exp(-r * T);
+    size_t num_blocks = (pairs + PATHS_PER_BLOCK - 1) / PATHS_PER_BLOCK;
+    bool   average    = option_type == OptionType::Asian;
+
+      // Per-asset constants of the kernel, hoisted out of the path loop
+    std::vector<Real> initial_prices(assetPtrs.size());
+    std::vector<Real> drifts(assetPtrs.size());
+    CorrelatedShocks<Real> shocks(A, dt);
+    BrownianBridge bridge(num_days_to_simulate);
+    size_t num_assets = assetPtrs.size();
+    for (size_t i = 0; i < assetPtrs.size(); ++i)
+    {
+        double sigma      = assetPtrs[i]->getReturnStdDev();
+        initial_prices[i] = static_cast<Real>(assetPtrs[i]->getLastRealValue());
+        drifts[i]         = static_cast<Real>((r - 0.5 * sigma * sigma) * dt);
+    }
+
+      // Thread-local results, written once per thread and reduced in thread order after
+      // the parallel loop, so no thread waits for another inside the path loop
+    size_t max_threads = static_cast<size_t>(omp_get_max_threads());
+    std::vector<std::vector<double>> thread_predicted_prices(max_threads);
+    std::vector<RunningCovariance> thread_statistics(max_threads);
+    std::vector<GreekStatistics> thread_greeks(max_threads);
+
+      // Expectation of the control variate, under the original drifts
+    double control_mean = controlVariateMean(initial_prices, drifts, A, dt, discount, strike_price, num_days_to_simulate, average);
+
+      // Importance sampling: the shift mu of the normals moves the drifts by sqrt(dt) A mu, and
+      // mu . sum_s z_s = sum_i c_i level_i with c = A^-T mu / sqrt(dt), so the likelihood
+      // ratio only needs the final levels of the paths. Every step adds the same drift
+      // shift, so exp(-n drift shift) turns the final prices back into the untilted ones
+    std::vector<Real> ratio_coefficients(num_assets, Real(0));
+    std::vector<double> diffusion_shifts(num_assets, 0.0);
+    std::vector<double> untilted_scales(num_assets, 1.0);
+    double half_shift_norm = 0.0;
+    if (importance_sampling)
+    {
+          // The pilot runs once per pricing run, the next calls reuse its shift
+        if (shift.size() != num_assets)
+        {
+            bool reached = false;
+            shift = importanceSamplingShift(initial_prices, drifts, A, shocks, dt, strike_price, average, seed, num_days_to_simulate, reached);
+            if (!reached)
+                std::cerr << "Warning: the importance sampling pilot did not reach the strike in " << PILOT_ITERATIONS
+                          << " iterations, few or no paths end in the exercise region" << std::endl;
+        }
+        std::vector<double> drift_shifts(num_assets);
+        lowerMatrixVectorProduct(A, shift.data(), drift_shifts.data());
+        for (size_t i = 0; i < num_assets; ++i)
+        {
+            double drift_shift = std::sqrt(dt) * drift_shifts[i];
+            drifts[i] = static_cast<Real>(static_cast<double>(drifts[i]) + drift_shift);
+            diffusion_shifts[i] = drift_shift;
+            untilted_scales[i]  = std::exp(-static_cast<double>(num_days_to_simulate) * drift_shift);
+            half_shift_norm += 0.5 * num_days_to_simulate * shift[i] * shift[i];
+        }
+
+          // Back substitution A^T c = mu
+        std::vector<double> coefficients(num_assets);
+        lowerTransposeSolve(A, shift.data(), coefficients.data());
+        for (size_t i = 0; i < num_assets; ++i)
+            ratio_coefficients[i] = static_cast<Real>(coefficients[i] / std::sqrt(dt));
+    }
+
+      // Constants of the control values of the simulated pairs
+    double log_mean = geometricLogMean(initial_prices, drifts, num_days_to_simulate);
+    std::vector<double> weights = geometricWeights(initial_prices);
+
+      // Constants of the Greeks, the volatility of the diffusion of every asset is the
+      // norm of its row of the Cholesky factor
+    bool sensitivities = greeks != nullptr;
+    GreekConstants greek_constants;
+    if (sensitivities)
+    {
+        greek_constants.initial_prices.resize(num_assets);
+        greek_constants.sigmas.resize(num_assets);
+        greek_constants.diffusion_scales.resize(num_assets);
+        for (size_t i = 0; i < num_assets; ++i)
+        {
+            const double *a = A.row(i);
+            double variance = 0.0;
+            for (size_t k = 0; k <= i; ++k)
+                variance += a[k] * a[k];
+            greek_constants.initial_prices[i]   = static_cast<double>(initial_prices[i]);
+            greek_constants.sigmas[i]           = assetPtrs[i]->getReturnStdDev();
+            greek_constants.diffusion_scales[i] = std::sqrt(variance);
+        }
+        greek_constants.diffusion_shifts   = diffusion_shifts;
+        greek_constants.inverse_covariance = inverseCovariance(A);
+        greek_constants.dt                 = dt;
+        greek_constants.T                  = T;
+        greek_constants.discount           = discount;
+        greek_constants.strike_price       = strike_price;
+        greek_constants.num_steps          = num_days_to_simulate;
+        greek_constants.average            = average;
+    }
 
 #pragma omp parallel
     {
-          // Random point vectors
-        double total_value_thread1 = 0.0;
-        double total_value_thread2 = 0.0;
-        double total_squared_value_thread1 = 0.0;
-        double total_squared_value_thread2 = 0.0;
-        std::vector<double> random_point_vector1(assetPtrs.size(), 0.0);
-        std::vector<double> random_point_vector2(assetPtrs.size(), 0.0);
+        RunningCovariance local_statistics;
+        std::vector<double> local_predicted_prices(assetPtrs.size(), 0.0);
+        std::vector<PathBlockState<Real>> states(assetPtrs.size());
+        std::vector<Real> normals;
+        std::vector<Real> increments;
+        std::vector<Real> basket1(PATHS_PER_BLOCK);
+        std::vector<Real> basket2(PATHS_PER_BLOCK);
+        std::vector<Real> level_sum(PATHS_PER_BLOCK);
+        std::vector<Real> pair_values(PATHS_PER_BLOCK);
+        std::vector<Real> control_values(PATHS_PER_BLOCK);
+        std::vector<Real> ratio1(PATHS_PER_BLOCK, Real(1));
+        std::vector<Real> ratio2(PATHS_PER_BLOCK, Real(1));
+        std::vector<double> points(sequence ? sequence->getDimension() * PATHS_PER_BLOCK : 0, 0.5);
+        std::vector<Real> first_increments(sensitivities ? num_assets * PATHS_PER_BLOCK : 0);
+        GreekBuffers greek_buffers(sensitivities ? num_assets : 0);
+        GreekStatistics local_greeks;
+        local_greeks.delta.resize(num_assets);
+        local_greeks.gamma.resize(num_assets);
 
-#pragma omp for reduction(+ : total_value, total_squared_value)
-        for (size_t i = 0; i < points / 2; ++i)
+#pragma omp for schedule(static)
+        for (size_t b = 0; b < num_blocks; ++b)
         {
-              // Generate random point
-            generateRandomPoint(random_point_vector1, random_point_vector2, assetPtrs, predicted_assets_prices, option_type, A, zeta_matrix, num_days_to_simulate);
+            size_t count = std::min(PATHS_PER_BLOCK, pairs - b * PATHS_PER_BLOCK);
+
+            std::fill(basket1.begin(), basket1.end(), Real(0));
+            std::fill(basket2.begin(), basket2.end(), Real(0));
+            std::fill(level_sum.begin(), level_sum.end(), Real(0));
+
+              // Every block of paths draws its shocks from its own stream
+            RandomStream stream(seed, b);
+            for (size_t i = 0; i < assetPtrs.size(); ++i)
+                resetPathBlock(states[i], initial_prices[i]);
 
-              // Check if the random point vector is not empty
-            if (random_point_vector1.size() != 0 && random_point_vector2.size() != 0)
+            if (sequence)
             {
-                error   = MonteCarloError::Success;
-                result1 = 0.0;
-                result2 = 0.0;
+                  // Coordinate level * num_assets + i of the point drives the number level of the
+                  // bridge of the asset i; the lanes past count keep 0.5, i.e. zero shocks
+                if (count < PATHS_PER_BLOCK)
+                    std::fill(points.begin(), points.end(), 0.5);
+                sequence->generateBlock(points, PATHS_PER_BLOCK, b * PATHS_PER_BLOCK, count);
+#pragma omp simd
+                for (size_t k = 0; k < points.size(); ++k)
+                    points[k] = simdInverseNormalCdf(points[k]);
 
-                  // Evaluate the payoff function with the random point
-                for (size_t i = 0; i < random_point_vector1.size(); ++i)
+                normals.resize(num_assets * num_days_to_simulate * PATHS_PER_BLOCK);
+                for (size_t i = 0; i < num_assets; ++i)
+                    bridge.build(&points[i * PATHS_PER_BLOCK], num_assets * PATHS_PER_BLOCK, PATHS_PER_BLOCK,
+                                 &normals[i * num_days_to_simulate * PATHS_PER_BLOCK]);
+
+                  // The whole paths at once, the bridge needs all the steps
+                shocks.correlate(num_days_to_simulate, PATHS_PER_BLOCK, normals, increments);
+                for (size_t i = 0; i < num_assets; ++i)
                 {
-                    result1 += random_point_vector1[i];
-                    result2 += random_point_vector2[i];
+                    const Real *asset_increments = &increments[i * num_days_to_simulate * PATHS_PER_BLOCK];
+                    if (sensitivities)
+                    {
+                        std::copy(asset_increments, asset_increments + PATHS_PER_BLOCK, &first_increments[i * PATHS_PER_BLOCK]);
+                        advanceSensitivityPathBlock(states[i], asset_increments, 0, num_days_to_simulate, count, drifts[i]);
+                    }
+                    else
+                        advancePathBlock(states[i], asset_increments, num_days_to_simulate, count, drifts[i]);
                 }
+            }
+            else
+            {
+                  // Fresh correlated shocks for a tile of steps, then every asset advances through them
+                for (size_t first_step = 0; first_step < num_days_to_simulate; first_step += STEPS_PER_TILE)
+                {
+                    size_t num_steps = std::min<size_t>(STEPS_PER_TILE, num_days_to_simulate - first_step);
+                    shocks.generate(stream, num_steps, PATHS_PER_BLOCK, normals, increments);
+
+                    for (size_t i = 0; i < num_assets; ++i)
+                    {
+                        const Real *asset_increments = &increments[i * num_steps * PATHS_PER_BLOCK];
+                        if (!sensitivities)
+                        {
+                            advancePathBlock(states[i], asset_increments, num_steps, count, drifts[i]);
+                            continue;
+                        }
+                        if (first_step == 0)
+                            std::copy(asset_increments, asset_increments + PATHS_PER_BLOCK, &first_increments[i * PATHS_PER_BLOCK]);
+                        advanceSensitivityPathBlock(states[i], asset_increments, first_step, num_steps, count, drifts[i]);
+                    }
+                }
+            }
 
-                result1 = std::max(0.0, (result1 - strike_price));
-                result2 = std::max(0.0, (result2 - strike_price));
+              // Likelihood ratios of the shifted paths and of their mirrors
+            if (importance_sampling)
+            {
+                std::fill(ratio1.begin(), ratio1.end(), Real(0));
+                for (size_t i = 0; i < num_assets; ++i)
+                {
+                    Real coefficient = ratio_coefficients[i];
+#pragma omp simd
+                    for (size_t p = 0; p < count; ++p)
+                        ratio1[p] += coefficient * states[i].level[p];
+                }
 
-                total_value_thread1 += result1;
-                total_value_thread2 += result2;
-                total_squared_value_thread1 += result1 * result1;
-                total_squared_value_thread2 += result2 * result2;
+                Real half_norm = static_cast<Real>(half_shift_norm);
+#pragma omp simd
+                for (size_t p = 0; p < count; ++p)
+                {
+                    Real projection = ratio1[p];
+                    ratio1[p] = simdExp(-projection - half_norm);
+                    ratio2[p] = simdExp(projection - half_norm);
+                }
+            }
+
+              // Calculate the predicted asset prices, the shifted drift of the importance
+              // sampling is taken out of every final price
+            for (size_t i = 0; i < assetPtrs.size(); ++i)
+            {
+                double final_sum = finishPathBlock(states[i], num_days_to_simulate, count, average, static_cast<Real>(weights[i]),
+                                                   basket1.data(), basket2.data(), level_sum.data());
+                local_predicted_prices[i] += final_sum * untilted_scales[i];
+            }
+
+              // The antithetic pair is one sample, its two payoffs are not independent
+            Real strike = static_cast<Real>(strike_price);
+            Real scale  = static_cast<Real>(0.5 * discount);
+#pragma omp simd
+            for (size_t p = 0; p < count; ++p)
+                pair_values[p] = (std::max(Real(0), basket1[p] - strike) * ratio1[p] + std::max(Real(0), basket2[p] - strike) * ratio2[p]) * scale;
+
+              // The control of the pair: the geometric Asian call or the final basket
+            Real log_base  = static_cast<Real>(log_mean);
+            Real log_scale = static_cast<Real>(1.0 / num_days_to_simulate);
+            if (average)
+            {
+#pragma omp simd
+                for (size_t p = 0; p < count; ++p)
+                {
+                    Real geometric1 = simdExp(log_base + log_scale * level_sum[p]);
+                    Real geometric2 = simdExp(log_base - log_scale * level_sum[p]);
+                    control_values[p] = (std::max(Real(0), geometric1 - strike) * ratio1[p] + std::max(Real(0), geometric2 - strike) * ratio2[p]) * scale;
+                }
             }
             else
             {
-                error = MonteCarloError::PointGenerationFailed;
-                i     = points / 2;
+#pragma omp simd
+                for (size_t p = 0; p < count; ++p)
+                    control_values[p] = (basket1[p] * ratio1[p] + basket2[p] * ratio2[p]) * scale;
             }
-        }
 
-#pragma omp critical
-        {
-            total_value += total_value_thread1 + total_value_thread2;
-            total_squared_value += total_squared_value_thread1 + total_squared_value_thread2;
+            local_statistics.addBlock(pair_values.data(), control_values.data(), count);
+
+            if (sensitivities)
+                addGreekSamples(greek_constants, states, first_increments.data(), basket1.data(), basket2.data(),
+                                ratio1.data(), ratio2.data(), pair_values.data(), count, greek_buffers, local_greeks);
         }
+
+        size_t thread = static_cast<size_t>(omp_get_thread_num());
+        thread_predicted_prices[thread] = std::move(local_predicted_prices);
+        thread_statistics[thread]       = local_statistics;
+        thread_greeks[thread]           = std::move(local_greeks);
     }
 
-    if (error == MonteCarloError::PointGenerationFailed)
+      // Reduce the thread-local results once per call
+    std::vector<double> call_predicted_prices(num_assets, 0.0);
+    for (size_t thread = 0; thread < max_threads; ++thread)
     {
+        statistics.merge(thread_statistics[thread]);
+        if (sensitivities)
+            mergeGreekStatistics(*greeks, thread_greeks[thread]);
+        for (size_t i = 0; i < thread_predicted_prices[thread].size(); ++i)
+            call_predicted_prices[i] += thread_predicted_prices[thread][i];
+    }
+
+    for (size_t i = 0; i < num_assets; ++i)
+        predicted_assets_prices[i] += call_predicted_prices[i];
+
+    return control_mean;
+}
+
+  // Function to calculate the option price prediction using the Monte Carlo method
+  // The function is the core of the finance oriented project, which is used to predict
+  // the option price prediction using the Monte Carlo method.
+std::pair<double, double> monteCarloPricePrediction(size_t points,
+                                                    const std::vector<const Asset *> &assetPtrs,
+                                                    const Matrix &A,
+                                                    RunningStatistics &statistics,
+                                                    const double strike_price,
+                                                    std::vector<double> &predicted_assets_prices,
+                                                    const OptionType &option_type,
+                                                    const PathPrecision &precision,
+                                                    const PathConstruction &construction,
+                                                    const VarianceReduction &variance_reduction,
+                                                    std::vector<double> &importance_shift,
+                                                    double &variance_ratio,
+                                                    GreekStatistics *greeks,
+                                                    uint64_t seed,
+                                                    MonteCarloError &error)
+{
+    RunningCovariance call_statistics;
+    GreekStatistics call_greeks;
+    double control_mean = 0.0;
+      // Number of days to simulate (1 day for European option, 252 days for Asian option
+    uint num_days_to_simulate = 1;
+    if (option_type == OptionType::Asian)
+    {
+        num_days_to_simulate = 252;
+    }
+
+    error = MonteCarloError::PointGenerationFailed;
+
+      // Start the timer
+    auto start = std::chrono::high_resolution_clock::now();
+
+      // Check that the Cholesky factor is the one of the assets
+    if (A.rows() != assetPtrs.size() || A.columns() != assetPtrs.size())
+    {
+        std::cerr << "The Cholesky factor does not match the assets" << std::endl;
         return std::make_pair(0.0, 0.0);
     }
 
-      // Calculate the option price
-    C  = total_value / static_cast<double>(points);
-    C0 = C * exp(-r * T);
+      // Sobol sequence of the Brownian bridge construction, scrambled with the seed
+    std::unique_ptr<QmcSequence> sequence;
+    if (construction == PathConstruction::BrownianBridgeSobol)
+    {
+        size_t dimension = assetPtrs.size() * num_days_to_simulate;
+        if (dimension > SobolSequence::MAX_DIMENSION)
+        {
+            std::cerr << "The Brownian bridge construction supports at most " << SobolSequence::MAX_DIMENSION
+                      << " assets times days, " << dimension << " requested" << std::endl;
+            return std::make_pair(0.0, 0.0);
+        }
+        sequence.reset(qmcSequenceFactory(SamplingMode::Sobol, dimension, seed, 0));
+    }
+
+    bool importance_sampling = variance_reduction == VarianceReduction::ImportanceSampling;
+    if (precision == PathPrecision::Single)
+        control_mean = pricePathBlocks<float>(points / 2, assetPtrs, call_statistics, strike_price, predicted_assets_prices, option_type, A, sequence.get(), importance_sampling, importance_shift, greeks ? &call_greeks : nullptr, seed, num_days_to_simulate);
+    else
+        control_mean = pricePathBlocks<double>(points / 2, assetPtrs, call_statistics, strike_price, predicted_assets_prices, option_type, A, sequence.get(), importance_sampling, importance_shift, greeks ? &call_greeks : nullptr, seed, num_days_to_simulate);
+
+    error = MonteCarloError::Success;
+
+      // Control variate with the optimal coefficient estimated from the same pairs:
+      // payoff - beta * (control - E[control]) keeps the mean and has the variance
+      // of the payoff times 1 - rho^2
+    RunningStatistics call_result = call_statistics.getStatisticsX();
+    variance_ratio = 1.0;
+    if (variance_reduction == VarianceReduction::ControlVariate && call_statistics.getVarianceY() > 0.0)
+    {
+        double beta     = call_statistics.getCovariance() / call_statistics.getVarianceY();
+        double mean     = call_statistics.getMeanX() - beta * (call_statistics.getMeanY() - control_mean);
+        double variance = std::max(0.0, call_statistics.getVarianceX() - beta * call_statistics.getCovariance());
+
+        call_result    = RunningStatistics::fromMoments(call_statistics.getCount(), mean, variance);
+        variance_ratio = variance > 0.0 ? call_statistics.getVarianceX() / variance : std::numeric_limits<double>::infinity();
+    }
 
-      // Calculate the variance
-    variance = total_squared_value / static_cast<double>(points) - (total_value / static_cast<double>(points)) * (total_value / static_cast<double>(points));
+      // Merge the statistics of the call; the pairs of one randomization of the
+      // sequence are not independent, only the mean of the call is a sample
+    if (sequence)
+        statistics.add(call_result.getMean());
+    else
+        statistics.merge(call_result);
+    if (greeks)
+        mergeGreekStatistics(*greeks, call_greeks, sequence != nullptr);
 
       // Stop the timer
     auto end      = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    return std::make_pair(C0, static_cast<double>(duration.count()));
+    return std::make_pair(call_result.getMean(), static_cast<double>(duration.count()));
 }
 
-  // Function to generate a random point
-void generateRandomPoint(std::vector<double> &random_point1,
-                         std::vector<double> &random_point2,
-                         const std::vector<const Asset *> &assetPtrs,
-                         std::vector<double> &predicted_assets_prices,
-                         const OptionType &option_type,
-                         const std::vector<std::vector<double>> &A,
-                         const std::vector<std::vector<double>> &zeta_matrix,
-                         const uint num_days_to_simulate)
+  // Function to simulate the antithetic pairs of paths block by block in the precision
+  // Real and to merge the discounted payoffs of every contract of the book into its statistics
+template <typename Real>
+static void priceBookBlocks(size_t pairs,
+                            const std::vector<const Asset *> &assetPtrs,
+                            const std::vector<OptionContract> &contracts,
+                            std::vector<RunningStatistics> &statistics,
+                            const Matrix &A,
+                            uint64_t seed,
+                            const uint num_days_to_simulate)
 {
-    double   T    = 1.0;                       /**Time to maturity */
-    double   r    = 0.05;                      /**Risk-free rate */
-    double   dt   = T / num_days_to_simulate;  /**Time step */
-    uint32_t seed = 123456789;                 /**Seed for the random number generator */
+    double r          = 0.05;
+    double T          = 1.0;
+    double dt         = T / num_days_to_simulate;
+    double discount   = exp(-r * T);
+    size_t num_blocks = (pairs + PATHS_PER_BLOCK - 1) / PATHS_PER_BLOCK;
+    size_t num_assets = assetPtrs.size();
 
-    try
+      // Per-asset constants of the kernel, hoisted out of the path loop
+    std::vector<Real> initial_prices(num_assets);
+    std::vector<Real> drifts(num_assets);
+    CorrelatedShocks<Real> shocks(A, dt);
+    for (size_t i = 0; i < num_assets; ++i)
     {
-        thread_local std::mt19937 eng(xorshift(seed));
+        double sigma      = assetPtrs[i]->getReturnStdDev();
+        initial_prices[i] = static_cast<Real>(assetPtrs[i]->getLastRealValue());
+        drifts[i]         = static_cast<Real>((r - 0.5 * sigma * sigma) * dt);
+    }
 
-        for (size_t i = 0; i < assetPtrs.size(); ++i)
-        {
-              // Geometry Brownian Motion price:
-            std::normal_distribution<double> distribution(0, 1);
-            double prices1[num_days_to_simulate + 1];
-            double prices2[num_days_to_simulate + 1];
+      // Contracts in structure-of-arrays layout
+    size_t num_contracts = contracts.size();
+    ContractArrays<Real> contract_arrays(contracts);
 
-              // Asian option prices
-            double asian_prices1 = 0.0;
-            double asian_prices2 = 0.0;
+      // Thread-local results, reduced in thread order after the parallel loop
+    size_t max_threads = static_cast<size_t>(omp_get_max_threads());
+    std::vector<std::vector<RunningStatistics>> thread_statistics(max_threads);
 
-              // Initial price
-            prices1[0] = assetPtrs[i]->getLastRealValue();
-            prices2[0] = assetPtrs[i]->getLastRealValue();
+#pragma omp parallel
+    {
+        std::vector<RunningStatistics> local_statistics(num_contracts);
+        std::vector<PathBlockState<Real>> states(num_assets);
+        std::vector<Real> normals;
+        std::vector<Real> increments;
+        BookBlockState<Real> book_block;
+        Real inverse_steps = Real(1) / static_cast<Real>(num_days_to_simulate);
+        Real scale         = static_cast<Real>(0.5 * discount);
 
-            for (uint step = 1; step < num_days_to_simulate + 1; ++step)
-            {
-                  // Perform the dot product to get the random number
-                double num = VVMult(A, i, zeta_matrix[step - 1]);
-
-                  // Calculate the price
-                prices1[step] = prices1[step - 1] * exp((r -
-                                                         0.5 *
-                                                             assetPtrs[i]->getReturnStdDev() *
-                                                             assetPtrs[i]->getReturnStdDev()) *
-                                                            dt +
-                                                        sqrt(dt) *
-                                                            num);
-                prices2[step] = prices2[step - 1] * exp((r -
-                                                         0.5 *
-                                                             assetPtrs[i]->getReturnStdDev() *
-                                                             assetPtrs[i]->getReturnStdDev()) *
-                                                            dt -
-                                                        sqrt(dt) *
-                                                            num);
-                  // Calculate the Asian option prices
-                if (option_type == OptionType::Asian)
-                {
-                    asian_prices1 += prices1[step];
-                    asian_prices2 += prices2[step];
-                }
-            }
-              // Calculate the random point
-              if (option_type == OptionType::Asian)
-              {
-                  random_point1[i] = asian_prices1 / num_days_to_simulate;
-                  random_point2[i] = asian_prices2 / num_days_to_simulate;
-              }
-              else if (option_type == OptionType::European)
-              {
-                  random_point1[i] = prices1[num_days_to_simulate];
-                  random_point2[i] = prices2[num_days_to_simulate];
-              }
-
-#pragma omp critical
+#pragma omp for schedule(static)
+        for (size_t b = 0; b < num_blocks; ++b)
+        {
+            size_t count = std::min(PATHS_PER_BLOCK, pairs - b * PATHS_PER_BLOCK);
+
+              // Every block of paths draws its shocks from its own stream
+            RandomStream stream(seed, b);
+            for (size_t i = 0; i < num_assets; ++i)
+                resetPathBlock(states[i], initial_prices[i]);
+
+            for (size_t first_step = 0; first_step < num_days_to_simulate; first_step += STEPS_PER_TILE)
             {
-                
-                  // Calculate the predicted asset prices
-                predicted_assets_prices[i] += prices1[num_days_to_simulate] + prices2[num_days_to_simulate];
+                size_t num_steps = std::min<size_t>(STEPS_PER_TILE, num_days_to_simulate - first_step);
+                shocks.generate(stream, num_steps, PATHS_PER_BLOCK, normals, increments);
+
+                for (size_t i = 0; i < num_assets; ++i)
+                    advancePathBlock(states[i], &increments[i * num_steps * PATHS_PER_BLOCK], num_steps, count, drifts[i]);
             }
+
+              // Final and average baskets of the pairs, then the payoffs of all the contracts
+            resetBookBlock(book_block);
+            for (size_t i = 0; i < num_assets; ++i)
+                addToBookBlock(book_block, states[i].price1, states[i].price2, states[i].sum1, states[i].sum2, count, inverse_steps);
+            priceBookBlock(book_block, contract_arrays, count, scale, local_statistics);
         }
+
+        size_t thread = static_cast<size_t>(omp_get_thread_num());
+        thread_statistics[thread] = std::move(local_statistics);
     }
-    catch (const std::exception &e)
+
+      // Reduce the thread-local results once per call
+    for (size_t thread = 0; thread < max_threads; ++thread)
+    {
+        for (size_t c = 0; c < thread_statistics[thread].size(); ++c)
+            statistics[c].merge(thread_statistics[thread][c]);
+    }
+}
+
+  // Function to price a book of options on the same simulated paths
+double monteCarloBookPricePrediction(size_t points,
+                                     const std::vector<const Asset *> &assetPtrs,
+                                     const Matrix &A,
+                                     const std::vector<OptionContract> &contracts,
+                                     std::vector<RunningStatistics> &statistics,
+                                     const PathPrecision &precision,
+                                     uint64_t seed,
+                                     MonteCarloError &error)
+{
+      // One step is enough unless a contract averages over the days
+    uint num_days_to_simulate = 1;
+    for (const OptionContract &contract : contracts)
     {
-        std::cerr << "Error occurred: " << e.what() << std::endl;
-        random_point1.clear();
-        random_point2.clear();
-        return;
+        if (contract.option_type == OptionType::Asian)
+            num_days_to_simulate = 252;
     }
-}
\ No newline at end of file
+
+    error = MonteCarloError::PointGenerationFailed;
+    statistics.resize(contracts.size());
+
+      // Start the timer
+    auto start = std::chrono::high_resolution_clock::now();
+
+      // Check that the Cholesky factor is the one of the assets
+    if (A.rows() != assetPtrs.size() || A.columns() != assetPtrs.size())
+    {
+        std::cerr << "The Cholesky factor does not match the assets" << std::endl;
+        return 0.0;
+    }
+
+    if (precision == PathPrecision::Single)
+        priceBookBlocks<float>(points / 2, assetPtrs, contracts, statistics, A, seed, num_days_to_simulate);
+    else
+        priceBookBlocks<double>(points / 2, assetPtrs, contracts, statistics, A, seed, num_days_to_simulate);
+
+    error = MonteCarloError::Success;
+
+      // Stop the timer
+    auto end      = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    return static_cast<double>(duration.count());
+}
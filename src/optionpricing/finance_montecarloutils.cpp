@@ -33,106 +33,342 @@ double calculateCovariance(const Asset &asset1, const Asset &asset2, CovarianceE
     return covariance;
 }
 
+  // Function to pack the returns minus their means: the row t of the matrix holds the
+  // returns of the day t of all the assets, the rows are padded with zeros to a multiple
+  // of COVARIANCE_MICRO_COLUMNS values
+static Matrix packDemeanedReturns(const std::vector<const Asset *> &assetPtrs, size_t num_days)
+{
+    size_t num_assets = assetPtrs.size();
+    Matrix packed(num_days, num_assets, COVARIANCE_MICRO_COLUMNS);
+
+      // Blocks of assets: every row of the block is written at once while the returns of
+      // the assets of the block are read as parallel streams
+    for (size_t i0 = 0; i0 < num_assets; i0 += COVARIANCE_MICRO_COLUMNS)
+    {
+        size_t i1 = std::min(num_assets, i0 + COVARIANCE_MICRO_COLUMNS);
+        for (size_t t = 0; t < num_days; ++t)
+        {
+            double *row = packed.row(t);
+            for (size_t i = i0; i < i1; ++i)
+                row[i] = assetPtrs[i]->getDailyReturn(t) - assetPtrs[i]->getReturnMean();
+        }
+    }
+
+    return packed;
+}
+
+  // Add the products of the rows [first_row, last_row) of the columns [i0, i0 + COVARIANCE_MICRO_ROWS)
+  // and [j0, j0 + COVARIANCE_MICRO_COLUMNS) of the packed returns to a micro tile of the covariance,
+  // the accumulators stay in registers for the whole range of rows
+static inline void covarianceMicroKernel(const double *X,
+                                         size_t ld,
+                                         size_t first_row,
+                                         size_t last_row,
+                                         size_t i0,
+                                         size_t j0,
+                                         double *tile,
+                                         size_t tile_ld)
+{
+    double accumulators[COVARIANCE_MICRO_ROWS][COVARIANCE_MICRO_COLUMNS] = {};
+
+    for (size_t t = first_row; t < last_row; ++t)
+    {
+        const double *row = X + t * ld;
+        for (size_t r = 0; r < COVARIANCE_MICRO_ROWS; ++r)
+        {
+            double x = row[i0 + r];
+#pragma omp simd
+            for (size_t c = 0; c < COVARIANCE_MICRO_COLUMNS; ++c)
+                accumulators[r][c] += x * row[j0 + c];
+        }
+    }
+
+    for (size_t r = 0; r < COVARIANCE_MICRO_ROWS; ++r)
+    {
+#pragma omp simd
+        for (size_t c = 0; c < COVARIANCE_MICRO_COLUMNS; ++c)
+            tile[r * tile_ld + c] += accumulators[r][c];
+    }
+}
+
   // Calculate covariance matrix for a vector of assets
-std::vector<std::vector<double>> calculateCovarianceMatrix(const std::vector<const Asset *> &assetPtrs, CovarianceError &error)
+Matrix calculateCovarianceMatrix(const std::vector<const Asset *> &assetPtrs, CovarianceError &error)
 {
     size_t numAssets = assetPtrs.size();
-    std::vector<std::vector<double>> covarianceMatrix(numAssets, std::vector<double>(numAssets, 0.0));
+    Matrix covarianceMatrix(numAssets, numAssets);
+    error = CovarianceError::Success;
+    if (numAssets == 0)
+        return covarianceMatrix;
 
-    try
+      // Check if the sizes of daily returns match
+    size_t numDays = assetPtrs[0]->getDailyReturnsSize();
+    for (const Asset *asset : assetPtrs)
     {
-          // Fill covariance matrix
-        for (size_t i = 0; i < numAssets; ++i)
+        if (asset->getDailyReturnsSize() != numDays)
         {
-            for (size_t j = 0; j < numAssets; ++j)
-            {
-                covarianceMatrix[i][j] = calculateCovariance(*assetPtrs[i], *assetPtrs[j], error);
-                if (error != CovarianceError::Success)
-                {
-                    return covarianceMatrix;
-                }
-            }
+            error = CovarianceError::Failure;
+            return covarianceMatrix;
         }
     }
-    catch (const std::exception &e)
+    if (numDays < 2)
     {
         error = CovarianceError::Failure;
+        return covarianceMatrix;
+    }
+
+    Matrix packed    = packDemeanedReturns(assetPtrs, numDays);
+    const double *X  = packed.data();
+    size_t ld        = packed.leadingDimension();
+
+      // Tiles of the lower triangle, numbered row by row
+    size_t numTiles     = (numAssets + COVARIANCE_TILE - 1) / COVARIANCE_TILE;
+    size_t numTilePairs = numTiles * (numTiles + 1) / 2;
+    double scale        = 1.0 / static_cast<double>(numDays - 1);
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t pair = 0; pair < numTilePairs; ++pair)
+    {
+          // Row I and column J <= I of the tile
+        size_t I = static_cast<size_t>((std::sqrt(8.0 * static_cast<double>(pair) + 1.0) - 1.0) / 2.0);
+        while (I * (I + 1) / 2 > pair)
+            --I;
+        while ((I + 1) * (I + 2) / 2 <= pair)
+            ++I;
+        size_t J = pair - I * (I + 1) / 2;
+
+        size_t i_begin = I * COVARIANCE_TILE, i_end = std::min(numAssets, i_begin + COVARIANCE_TILE);
+        size_t j_begin = J * COVARIANCE_TILE, j_end = std::min(numAssets, j_begin + COVARIANCE_TILE);
+
+          // The days are processed in chunks: the rows of the chunk stay in the cache
+          // while all the micro tiles of the tile read them
+        alignas(64) double tile[COVARIANCE_TILE * COVARIANCE_TILE] = {};
+        for (size_t first_row = 0; first_row < numDays; first_row += COVARIANCE_ROW_CHUNK)
+        {
+            size_t last_row = std::min(numDays, first_row + COVARIANCE_ROW_CHUNK);
+            for (size_t i0 = i_begin; i0 < i_end; i0 += COVARIANCE_MICRO_ROWS)
+            {
+                  // Only the micro tiles with entries on or below the diagonal
+                for (size_t j0 = j_begin; j0 < j_end && j0 < i0 + COVARIANCE_MICRO_ROWS; j0 += COVARIANCE_MICRO_COLUMNS)
+                    covarianceMicroKernel(X, ld, first_row, last_row, i0, j0,
+                                          &tile[(i0 - i_begin) * COVARIANCE_TILE + (j0 - j_begin)], COVARIANCE_TILE);
+            }
+        }
+
+          // Keep the entries of the lower triangle, mirrored to the upper one
+        for (size_t i = i_begin; i < i_end; ++i)
+        {
+            for (size_t j = j_begin; j < j_end && j <= i; ++j)
+            {
+                double covariance = tile[(i - i_begin) * COVARIANCE_TILE + (j - j_begin)] * scale;
+                covarianceMatrix(i, j) = covariance;
+                covarianceMatrix(j, i) = covariance;
+            }
+        }
     }
 
     return covarianceMatrix;
 }
 
-std::vector<std::vector<double>> choleskyFactorization(const std::vector<std::vector<double>> &A, double step_size)
+  // Factorize the diagonal block [k0, k1) of the panel column by column, the columns before
+  // k0 have already been removed by the trailing updates. A pivot below its floor is raised
+  // to it and the column is marked as clipped: the rest of the column only holds rounding
+  // errors, which divided by the small pivot would grow from one column to the next, so it
+  // is set to zero. The return value tells if any pivot was clipped
+static bool factorizeDiagonalBlock(Matrix &A, size_t k0, size_t k1, const std::vector<double> &floors, std::vector<unsigned char> &clipped)
 {
-    int n = A.size();
-    std::vector<std::vector<double>> L(n, std::vector<double>(n, 0.0));
+    bool regularized = false;
 
-    for (int c = 0; c < n; ++c)
+    for (size_t c = k0; c < k1; ++c)
     {
-        double sum = 0.0;
+        double *row_c = A.row(c);
+        double sum    = 0.0;
+#pragma omp simd reduction(+ : sum)
+        for (size_t k = k0; k < c; ++k)
+            sum += row_c[k] * row_c[k];
 
-          // Efficiently calculate L(c, c) using previously computed L elements
-        for (int k = 0; k < c; ++k)
+        double pivot = row_c[c] - sum;
+        if (!(pivot >= floors[c]))
         {
-            sum += L[c][k] * L[c][k];
+            pivot       = floors[c];
+            clipped[c]  = 1;
+            regularized = true;
         }
-        L[c][c] = sqrt(A[c][c] - sum);  // Handle potential negative values by returning an empty matrix
+        row_c[c] = std::sqrt(pivot);
 
-          // Check for positive-definite condition
-        if (L[c][c] <= 0.0)
+          // The rest of the column c of the block, from the rows already computed
+        for (size_t i = c + 1; i < k1; ++i)
         {
-            return std::vector<std::vector<double>>();  // Matrix not positive-definite
+            double *row_i = A.row(i);
+            sum = 0.0;
+#pragma omp simd reduction(+ : sum)
+            for (size_t k = k0; k < c; ++k)
+                sum += row_i[k] * row_c[k];
+            row_i[c] = clipped[c] ? 0.0 : (row_i[c] - sum) / row_c[c];
         }
+    }
+
+    return regularized;
+}
 
-          // Update the rest of the c-th column of L
-        if (c + step_size < n)
+  // Solve the rows [k1, n) of the panel [k0, k1) against the factorized diagonal block,
+  // L_21 = A_21 L_11^-T. The rows are independent and are solved in groups, column by
+  // column, so an entry is not read back right after being written
+static void solvePanel(Matrix &A, size_t k0, size_t k1, const std::vector<unsigned char> &clipped)
+{
+    size_t n         = A.rows();
+    size_t numGroups = (n - k1 + CHOLESKY_PANEL_ROWS - 1) / CHOLESKY_PANEL_ROWS;
+
+#pragma omp parallel for schedule(static)
+    for (size_t group = 0; group < numGroups; ++group)
+    {
+        size_t first = k1 + group * CHOLESKY_PANEL_ROWS;
+        size_t last  = std::min(n, first + CHOLESKY_PANEL_ROWS);
+        for (size_t c = k0; c < k1; ++c)
         {
-            for (int i = c + 1; i < n; ++i)
+            const double *row_c = A.row(c);
+            for (size_t i = first; i < last; ++i)
             {
-                sum = 0.0;
-                for (int k = 0; k < c; ++k)
-                {
-                    sum += L[i][k] * L[c][k];
-                }
-                L[i][c] = (A[i][c] - sum) / L[c][c];
+                double *row_i = A.row(i);
+                double sum    = 0.0;
+#pragma omp simd reduction(+ : sum)
+                for (size_t k = k0; k < c; ++k)
+                    sum += row_i[k] * row_c[k];
+                row_i[c] = clipped[c] ? 0.0 : (row_i[c] - sum) / row_c[c];
             }
         }
     }
-
-    return L;
 }
 
-  // Function to generate a metrix of random numbers from a normal distribution
-void fillZetaMatrix(std::vector<std::vector<double>> &zeta_matrix)
+  // Subtract L_21 L_21^T from the trailing lower triangle [k1, n). The panel is packed
+  // transposed, so its row k holds the column k0 + k of the rows [k1, n) and the product
+  // has the shape of the covariance X^T X, computed by tiles with the same micro kernel
+static void updateTrailingMatrix(Matrix &A, size_t k0, size_t k1, Matrix &panel)
 {
-    std::random_device rd;
-    std::mt19937 eng(rd());
-    for (size_t i = 0; i < zeta_matrix.size(); ++i)
+    size_t n     = A.rows();
+    size_t width = k1 - k0;
+    size_t m     = n - k1;
+
+    for (size_t i = 0; i < m; ++i)
     {
-        std::normal_distribution<double> distribution(0, 1);
-        for (size_t j = 0; j < zeta_matrix[i].size(); ++j)
+        const double *row_i = A.row(k1 + i);
+        for (size_t k = 0; k < width; ++k)
+            panel(k, i) = row_i[k0 + k];
+    }
+
+    const double *X = panel.data();
+    size_t ld       = panel.leadingDimension();
+
+      // Tiles of the trailing lower triangle, numbered row by row
+    size_t numTiles     = (m + COVARIANCE_TILE - 1) / COVARIANCE_TILE;
+    size_t numTilePairs = numTiles * (numTiles + 1) / 2;
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t pair = 0; pair < numTilePairs; ++pair)
+    {
+          // Row I and column J <= I of the tile
+        size_t I = static_cast<size_t>((std::sqrt(8.0 * static_cast<double>(pair) + 1.0) - 1.0) / 2.0);
+        while (I * (I + 1) / 2 > pair)
+            --I;
+        while ((I + 1) * (I + 2) / 2 <= pair)
+            ++I;
+        size_t J = pair - I * (I + 1) / 2;
+
+        size_t i_begin = I * COVARIANCE_TILE, i_end = std::min(m, i_begin + COVARIANCE_TILE);
+        size_t j_begin = J * COVARIANCE_TILE, j_end = std::min(m, j_begin + COVARIANCE_TILE);
+
+        alignas(64) double tile[COVARIANCE_TILE * COVARIANCE_TILE] = {};
+        for (size_t i0 = i_begin; i0 < i_end; i0 += COVARIANCE_MICRO_ROWS)
+        {
+              // Only the micro tiles with entries on or below the diagonal
+            for (size_t j0 = j_begin; j0 < j_end && j0 < i0 + COVARIANCE_MICRO_ROWS; j0 += COVARIANCE_MICRO_COLUMNS)
+                covarianceMicroKernel(X, ld, 0, width, i0, j0,
+                                      &tile[(i0 - i_begin) * COVARIANCE_TILE + (j0 - j_begin)], COVARIANCE_TILE);
+        }
+
+        for (size_t i = i_begin; i < i_end; ++i)
         {
-            zeta_matrix[i][j] = distribution(eng);
+            double *row_i        = A.row(k1 + i) + k1 + j_begin;
+            const double *update = &tile[(i - i_begin) * COVARIANCE_TILE];
+            size_t length        = std::min(j_end, i + 1) - j_begin;
+#pragma omp simd
+            for (size_t j = 0; j < length; ++j)
+                row_i[j] -= update[j];
         }
     }
 }
 
-  // Function to compute a vector-vector multiplication
-double VVMult(const std::vector<std::vector<double>> &matrix, size_t rowIdx, const std::vector<double> &vector)
+  // Blocked right-looking Cholesky factorization, in the storage of the matrix
+Matrix choleskyFactorization(Matrix A, CholeskyError &error)
 {
-    double result = 0.0;
-    for (size_t i = 0; i < vector.size(); ++i)
+    size_t n = A.rows();
+    error    = CholeskyError::Success;
+
+      // Check that the lower triangle is finite and that some variance is positive
+    double max_diagonal = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double *row_i = A.row(i);
+        for (size_t k = 0; k <= i; ++k)
+        {
+            if (!std::isfinite(row_i[k]))
+            {
+                error = CholeskyError::Failure;
+                return Matrix();
+            }
+        }
+        max_diagonal = std::max(max_diagonal, row_i[i]);
+    }
+    if (n > 0 && !(max_diagonal > 0.0))
     {
-        result += matrix[rowIdx][i] * vector[i];
+        error = CholeskyError::Failure;
+        return Matrix();
     }
-    return result;
+
+      // Smallest pivot of every row, relative to its variance, or to the largest one
+      // for the rows without a positive variance
+    std::vector<double> floors(n);
+    for (size_t i = 0; i < n; ++i)
+        floors[i] = CHOLESKY_PIVOT_TOLERANCE * (A(i, i) > 0.0 ? A(i, i) : max_diagonal);
+
+    bool regularized = false;
+    std::vector<unsigned char> clipped(n, 0);
+    Matrix panel(CHOLESKY_BLOCK, n > CHOLESKY_BLOCK ? n - CHOLESKY_BLOCK : 0, COVARIANCE_MICRO_COLUMNS);
+    for (size_t k0 = 0; k0 < n; k0 += CHOLESKY_BLOCK)
+    {
+        size_t k1 = std::min(n, k0 + CHOLESKY_BLOCK);
+        regularized |= factorizeDiagonalBlock(A, k0, k1, floors, clipped);
+        if (k1 < n)
+        {
+            solvePanel(A, k0, k1, clipped);
+            updateTrailingMatrix(A, k0, k1, panel);
+        }
+    }
+
+      // Clear the upper triangle, which still holds the input
+    for (size_t i = 0; i < n; ++i)
+        std::fill(A.row(i) + i + 1, A.row(i) + n, 0.0);
+
+    if (regularized)
+        error = CholeskyError::Regularized;
+    return A;
 }
 
-  // Function that shifts the seed
-uint32_t xorshift(uint32_t seed)
+  // Cholesky factorization of the covariance matrix of a pricing run, with its errors reported once
+Matrix factorizeCovarianceMatrix(const Matrix &covariance_matrix, size_t num_assets, CholeskyError &error)
 {
-    seed ^= seed << 13;
-    seed ^= seed >> 17;
-    seed ^= seed << 5;
-    return seed;
+      // Check that the covariance matrix is the one of the assets
+    if (covariance_matrix.rows() != num_assets || covariance_matrix.columns() != num_assets)
+    {
+        std::cerr << "The covariance matrix does not match the assets" << std::endl;
+        error = CholeskyError::Failure;
+        return Matrix();
+    }
+
+      // A singular or near-singular matrix is regularized
+    Matrix A = choleskyFactorization(covariance_matrix, error);
+    if (error == CholeskyError::Failure)
+        std::cerr << "Error factorizing the covariance matrix" << std::endl;
+    if (error == CholeskyError::Regularized)
+        std::cerr << "Warning: the covariance matrix is not positive definite, its smallest pivots were regularized" << std::endl;
+    return A;
 }
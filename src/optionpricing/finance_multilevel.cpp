@@ -0,0 +1,292 @@
+#include "../../include/optionpricing/finance_multilevel.hpp"
+
+  // Function to get the grids of the levels, the spacing of the points halves from one
+  // level to the next and the last day is always a point
+std::vector<MultilevelLevel> multilevelGrids(size_t num_days)
+{
+    size_t finest = 0;
+    while ((static_cast<size_t>(1) << finest) < num_days)
+        ++finest;
+
+    std::vector<MultilevelLevel> levels(finest + 1);
+    for (size_t l = 0; l <= finest; ++l)
+    {
+        levels[l].step_days = std::min(static_cast<size_t>(1) << (finest - l), num_days);
+        levels[l].num_steps = (num_days + levels[l].step_days - 1) / levels[l].step_days;
+    }
+    return levels;
+}
+
+  // Function to simulate the blocks first_block .. first_block + num_blocks - 1 of a level
+  // in the precision Real and to merge their corrections and fine payoffs into the
+  // samples of the level. On the level 0 the coarse payoff is zero and the sums of the
+  // final prices are added to final_sums
+template <typename Real>
+static void simulateLevelBlocks(const std::vector<const Asset *> &assetPtrs,
+                                const Matrix &A,
+                                const double strike_price,
+                                size_t level,
+                                size_t num_days,
+                                size_t first_block,
+                                size_t num_blocks,
+                                uint64_t seed,
+                                MultilevelLevel &samples,
+                                std::vector<double> &final_sums)
+{
+    double r          = 0.05;
+    double T          = 1.0;
+    double day        = T / num_days;
+    double discount   = exp(-r * T);
+    size_t num_assets = assetPtrs.size();
+    bool   coupled    = level > 0;
+
+      // The fine grid has uniform steps of step_days days, then a shorter last step if the
+      // days are not a multiple of them; the coarse grid has steps twice as long, then a
+      // last step up to the last day
+    size_t step_days        = samples.step_days;
+    size_t uniform_steps    = num_days / step_days;
+    size_t last_days        = num_days - uniform_steps * step_days;
+    size_t coarse_last_days = num_days - num_days / (2 * step_days) * (2 * step_days);
+
+      // Per-asset constants of the kernel, hoisted out of the path loop
+    std::vector<Real> initial_prices(num_assets);
+    std::vector<Real> drifts(num_assets);
+    std::vector<Real> last_drifts(num_assets);
+    CorrelatedShocks<Real> shocks(A, step_days * day);
+    CorrelatedShocks<Real> last_shocks(A, (last_days > 0 ? last_days : step_days) * day);
+    for (size_t i = 0; i < num_assets; ++i)
+    {
+        double sigma      = assetPtrs[i]->getReturnStdDev();
+        initial_prices[i] = static_cast<Real>(assetPtrs[i]->getLastRealValue());
+        drifts[i]         = static_cast<Real>((r - 0.5 * sigma * sigma) * step_days * day);
+        last_drifts[i]    = static_cast<Real>((r - 0.5 * sigma * sigma) * last_days * day);
+    }
+
+      // Weights of the prices in the averages: the lengths of the steps in units of T
+    Real fine_weight        = static_cast<Real>(static_cast<double>(step_days) / num_days);
+    Real last_weight        = static_cast<Real>(static_cast<double>(last_days) / num_days);
+    Real coarse_weight      = 2 * fine_weight;
+    Real coarse_last_weight = static_cast<Real>(static_cast<double>(coarse_last_days) / num_days);
+    Real last_included      = last_days > 0 ? Real(1) : Real(0);
+
+      // Thread-local results, reduced in thread order after the parallel loop
+    size_t max_threads = static_cast<size_t>(omp_get_max_threads());
+    std::vector<RunningStatistics> thread_corrections(max_threads);
+    std::vector<RunningStatistics> thread_fines(max_threads);
+    std::vector<std::vector<double>> thread_final_sums(max_threads);
+
+#pragma omp parallel
+    {
+        RunningStatistics local_correction;
+        RunningStatistics local_fine;
+        std::vector<double> local_final_sums(num_assets, 0.0);
+        std::vector<PathBlockState<Real>> states(num_assets);
+        std::vector<Real> normals;
+        std::vector<Real> increments;
+        std::vector<Real> fine1(PATHS_PER_BLOCK), fine2(PATHS_PER_BLOCK);
+        std::vector<Real> coarse1(PATHS_PER_BLOCK), coarse2(PATHS_PER_BLOCK);
+        std::vector<Real> correction_values(PATHS_PER_BLOCK);
+        std::vector<Real> fine_values(PATHS_PER_BLOCK);
+
+#pragma omp for schedule(static)
+        for (size_t b = 0; b < num_blocks; ++b)
+        {
+              // Every block of every level draws its shocks from its own stream
+            RandomStream stream(seed, ((static_cast<uint64_t>(level) + 1) << 48) + first_block + b);
+            for (size_t i = 0; i < num_assets; ++i)
+                resetPathBlock(states[i], initial_prices[i]);
+
+            for (size_t first_step = 0; first_step < uniform_steps; first_step += STEPS_PER_TILE)
+            {
+                size_t num_steps = std::min<size_t>(STEPS_PER_TILE, uniform_steps - first_step);
+                shocks.generate(stream, num_steps, PATHS_PER_BLOCK, normals, increments);
+
+                for (size_t i = 0; i < num_assets; ++i)
+                    advanceCoupledPathBlock(states[i], &increments[i * num_steps * PATHS_PER_BLOCK], first_step, num_steps, PATHS_PER_BLOCK, drifts[i]);
+            }
+
+              // The shorter last step is never a point of the coarse grid but the last day
+            if (last_days > 0)
+            {
+                last_shocks.generate(stream, 1, PATHS_PER_BLOCK, normals, increments);
+                for (size_t i = 0; i < num_assets; ++i)
+                    advanceCoupledPathBlock(states[i], &increments[i * PATHS_PER_BLOCK], 0, 1, PATHS_PER_BLOCK, last_drifts[i]);
+            }
+
+              // Baskets of the averages on the two grids, the last price has its own weights
+            std::fill(fine1.begin(), fine1.end(), Real(0));
+            std::fill(fine2.begin(), fine2.end(), Real(0));
+            std::fill(coarse1.begin(), coarse1.end(), Real(0));
+            std::fill(coarse2.begin(), coarse2.end(), Real(0));
+            for (size_t i = 0; i < num_assets; ++i)
+            {
+                const PathBlockState<Real> &state = states[i];
+#pragma omp simd
+                for (size_t p = 0; p < PATHS_PER_BLOCK; ++p)
+                {
+                    fine1[p]   += fine_weight * (state.sum1[p] - last_included * state.price1[p]) + last_weight * state.price1[p];
+                    fine2[p]   += fine_weight * (state.sum2[p] - last_included * state.price2[p]) + last_weight * state.price2[p];
+                    coarse1[p] += coarse_weight * state.coarse_sum1[p] + coarse_last_weight * state.price1[p];
+                    coarse2[p] += coarse_weight * state.coarse_sum2[p] + coarse_last_weight * state.price2[p];
+                }
+
+                if (!coupled)
+                {
+                    for (size_t p = 0; p < PATHS_PER_BLOCK; ++p)
+                        local_final_sums[i] += static_cast<double>(state.price1[p]) + static_cast<double>(state.price2[p]);
+                }
+            }
+
+              // The antithetic pair is one sample of the correction and of the fine payoff
+            Real strike          = static_cast<Real>(strike_price);
+            Real scale           = static_cast<Real>(0.5 * discount);
+            Real coarse_included = coupled ? Real(1) : Real(0);
+#pragma omp simd
+            for (size_t p = 0; p < PATHS_PER_BLOCK; ++p)
+            {
+                Real fine   = std::max(Real(0), fine1[p] - strike) + std::max(Real(0), fine2[p] - strike);
+                Real coarse = std::max(Real(0), coarse1[p] - strike) + std::max(Real(0), coarse2[p] - strike);
+                fine_values[p]       = fine * scale;
+                correction_values[p] = (fine - coarse_included * coarse) * scale;
+            }
+
+            local_correction.addBlock(correction_values.data(), PATHS_PER_BLOCK);
+            local_fine.addBlock(fine_values.data(), PATHS_PER_BLOCK);
+        }
+
+        size_t thread = static_cast<size_t>(omp_get_thread_num());
+        thread_corrections[thread] = local_correction;
+        thread_fines[thread]       = local_fine;
+        thread_final_sums[thread]  = std::move(local_final_sums);
+    }
+
+      // Reduce the thread-local results once per call
+    for (size_t thread = 0; thread < max_threads; ++thread)
+    {
+        samples.correction.merge(thread_corrections[thread]);
+        samples.fine.merge(thread_fines[thread]);
+        for (size_t i = 0; i < thread_final_sums[thread].size(); ++i)
+            final_sums[i] += thread_final_sums[thread][i];
+    }
+}
+
+  // Function to calculate the price of an Asian option with the multilevel Monte Carlo method
+std::pair<double, double> multilevelPricePrediction(const std::vector<const Asset *> &assetPtrs,
+                                                    const Matrix &A,
+                                                    const double strike_price,
+                                                    const PathPrecision &precision,
+                                                    StoppingRule rule,
+                                                    double tolerance,
+                                                    size_t points,
+                                                    size_t max_points,
+                                                    uint64_t seed,
+                                                    std::vector<MultilevelLevel> &levels,
+                                                    double &standard_error,
+                                                    std::vector<double> &predicted_assets_prices,
+                                                    MonteCarloError &error)
+{
+    size_t num_days_to_simulate = 252;
+
+    error = MonteCarloError::PointGenerationFailed;
+
+      // Start the timer
+    auto start = std::chrono::high_resolution_clock::now();
+
+      // Check that the Cholesky factor is the one of the assets
+    if (A.rows() != assetPtrs.size() || A.columns() != assetPtrs.size())
+    {
+        std::cerr << "The Cholesky factor does not match the assets" << std::endl;
+        return std::make_pair(0.0, 0.0);
+    }
+
+    levels = multilevelGrids(num_days_to_simulate);
+    size_t num_levels = levels.size();
+
+      // Simulate more blocks of a level, the blocks already simulated keep their streams
+    std::vector<size_t> blocks(num_levels, 0);
+    std::vector<double> final_sums(assetPtrs.size(), 0.0);
+    auto simulate = [&](size_t l, size_t new_blocks)
+    {
+        if (precision == PathPrecision::Single)
+            simulateLevelBlocks<float>(assetPtrs, A, strike_price, l, num_days_to_simulate, blocks[l], new_blocks, seed, levels[l], final_sums);
+        else
+            simulateLevelBlocks<double>(assetPtrs, A, strike_price, l, num_days_to_simulate, blocks[l], new_blocks, seed, levels[l], final_sums);
+        blocks[l] += new_blocks;
+    };
+
+    for (size_t l = 0; l < num_levels; ++l)
+        simulate(l, MULTILEVEL_PILOT_PAIRS / PATHS_PER_BLOCK);
+
+      // Costs in pairs times steps
+    double max_cost    = 0.5 * static_cast<double>(max_points) * static_cast<double>(num_days_to_simulate);
+    double budget_cost = 0.5 * static_cast<double>(points) * static_cast<double>(num_days_to_simulate);
+
+    double estimate = 0.0;
+    for (size_t round = 0; round < MULTILEVEL_MAX_ROUNDS; ++round)
+    {
+          // Current estimate and its variance
+        estimate = 0.0;
+        double variance = 0.0;
+        for (const MultilevelLevel &level : levels)
+        {
+            estimate += level.correction.getMean();
+            variance += level.correction.getVariance() / static_cast<double>(level.correction.getCount());
+        }
+        if (rule != StoppingRule::FixedPoints && targetPrecisionReached(estimate, std::sqrt(variance), rule, tolerance))
+            break;
+
+          // Optimal numbers of pairs N_l = scale * sqrt(V_l / C_l), which cost scale * sum_l sqrt(V_l C_l)
+        double root_sum = 0.0;
+        for (const MultilevelLevel &level : levels)
+            root_sum += std::sqrt(level.correction.getVariance() * static_cast<double>(level.num_steps));
+        if (root_sum <= 0.0)
+            break;
+
+        double scale = budget_cost / root_sum;
+        if (rule != StoppingRule::FixedPoints)
+        {
+            double target = rule == StoppingRule::RelativeTolerance ? tolerance * std::fabs(estimate) : tolerance;
+            double target_variance = (target / 1.96) * (target / 1.96);
+            scale = target_variance > 0.0 ? 1.1 * root_sum / target_variance : max_cost / root_sum;
+        }
+        scale = std::min(scale, max_cost / root_sum);
+
+          // Blocks still missing on every level
+        bool added = false;
+        for (size_t l = 0; l < num_levels; ++l)
+        {
+            double pairs  = scale * std::sqrt(levels[l].correction.getVariance() / static_cast<double>(levels[l].num_steps));
+            size_t needed = static_cast<size_t>(std::ceil(pairs / static_cast<double>(PATHS_PER_BLOCK)));
+            if (needed > blocks[l])
+            {
+                simulate(l, needed - blocks[l]);
+                added = true;
+            }
+        }
+
+        if (!added || rule == StoppingRule::FixedPoints)
+            break;
+    }
+
+      // Telescoping sum and its standard error, the levels are independent
+    estimate = 0.0;
+    double variance = 0.0;
+    for (const MultilevelLevel &level : levels)
+    {
+        estimate += level.correction.getMean();
+        variance += level.correction.getVariance() / static_cast<double>(level.correction.getCount());
+    }
+    standard_error = std::sqrt(variance);
+
+      // The final prices of the level 0 are exact samples of the prices in one year
+    double final_paths = 2.0 * static_cast<double>(levels[0].correction.getCount());
+    for (size_t i = 0; i < assetPtrs.size(); ++i)
+        predicted_assets_prices[i] = final_sums[i] / final_paths;
+
+    error = MonteCarloError::Success;
+
+      // Stop the timer
+    auto end      = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    return std::make_pair(estimate, static_cast<double>(duration.count()));
+}
@@ -0,0 +1,309 @@
+#include "../../include/optionpricing/finance_pathstore.hpp"
+
+#include <cstring>
+
+  // Function to get the offset of the first column of a path store
+size_t pathStoreDataOffset(size_t num_assets)
+{
+    size_t offset = sizeof(PathStoreHeader) + num_assets * sizeof(PathStoreAsset) + num_assets * num_assets * sizeof(double);
+    return (offset + PATH_STORE_ALIGNMENT - 1) / PATH_STORE_ALIGNMENT * PATH_STORE_ALIGNMENT;
+}
+
+  // Function to get the distance between the starts of two consecutive columns
+size_t pathStoreColumnStride(size_t num_pairs, size_t value_size)
+{
+    size_t bytes = num_pairs * value_size;
+    return (bytes + PATH_STORE_ALIGNMENT - 1) / PATH_STORE_ALIGNMENT * PATH_STORE_ALIGNMENT;
+}
+
+  // Function to open and validate a path store
+PathStoreError PathStore::open(const std::string &filename)
+{
+    if (!file.openRead(filename))
+    {
+        std::cerr << "Could not open the path store " << filename << std::endl;
+        return PathStoreError::FileOpenError;
+    }
+
+      // Check the header before reading anything it points to
+    const PathStoreHeader *store_header = reinterpret_cast<const PathStoreHeader *>(file.data());
+    bool valid = file.size() >= sizeof(PathStoreHeader)
+                 && std::memcmp(store_header->magic, PATH_STORE_MAGIC, sizeof(PATH_STORE_MAGIC)) == 0
+                 && store_header->version == PATH_STORE_VERSION
+                 && (store_header->value_size == sizeof(float) || store_header->value_size == sizeof(double))
+                 && store_header->num_assets > 0;
+    if (valid)
+    {
+        size_t num_columns = static_cast<size_t>(PathColumn::Count) * store_header->num_assets;
+        size_t required    = pathStoreDataOffset(store_header->num_assets)
+                             + num_columns * pathStoreColumnStride(store_header->num_pairs, store_header->value_size);
+        valid = file.size() >= required;
+    }
+
+    if (!valid)
+    {
+        std::cerr << "The file " << filename << " is not a valid path store" << std::endl;
+        file.close();
+        return PathStoreError::InvalidFormat;
+    }
+
+    return PathStoreError::Success;
+}
+
+  // Function to get the covariance of the daily returns of two assets
+double PathStore::covariance(size_t i, size_t j) const
+{
+    const unsigned char *matrix = file.data() + sizeof(PathStoreHeader) + header().num_assets * sizeof(PathStoreAsset);
+    double value;
+    std::memcpy(&value, matrix + (i * header().num_assets + j) * sizeof(double), sizeof(double));
+    return value;
+}
+
+  // Function to get the at-the-money strike price of the basket
+double PathStore::atTheMoneyStrike() const
+{
+    double strike = 0.0;
+    for (size_t i = 0; i < header().num_assets; ++i)
+        strike += asset(i).initial_price;
+
+    return strike;
+}
+
+  // Function to get the offset of a column
+size_t PathStore::columnOffset(PathColumn kind, size_t asset) const
+{
+    size_t index = static_cast<size_t>(kind) * header().num_assets + asset;
+    return pathStoreDataOffset(header().num_assets) + index * pathStoreColumnStride(header().num_pairs, header().value_size);
+}
+
+  // Function to simulate the blocks of pairs and write their final prices and averages to the columns
+template <typename Real>
+static void writePathBlocks(size_t pairs,
+                            const std::vector<const Asset *> &assetPtrs,
+                            const Matrix &A,
+                            uint64_t seed,
+                            const PathStoreHeader &store_header,
+                            unsigned char *data)
+{
+    double dt         = store_header.maturity / store_header.num_days;
+    size_t num_days   = store_header.num_days;
+    size_t num_blocks = (pairs + PATHS_PER_BLOCK - 1) / PATHS_PER_BLOCK;
+    size_t num_assets = assetPtrs.size();
+    size_t stride     = pathStoreColumnStride(pairs, sizeof(Real));
+
+      // Per-asset constants of the kernel and columns of the file
+    std::vector<Real> initial_prices(num_assets);
+    std::vector<Real> drifts(num_assets);
+    std::vector<Real *> columns(static_cast<size_t>(PathColumn::Count) * num_assets);
+    CorrelatedShocks<Real> shocks(A, dt);
+    for (size_t i = 0; i < num_assets; ++i)
+    {
+        double sigma      = assetPtrs[i]->getReturnStdDev();
+        initial_prices[i] = static_cast<Real>(assetPtrs[i]->getLastRealValue());
+        drifts[i]         = static_cast<Real>((store_header.rate - 0.5 * sigma * sigma) * dt);
+    }
+    for (size_t k = 0; k < columns.size(); ++k)
+        columns[k] = reinterpret_cast<Real *>(data + pathStoreDataOffset(num_assets) + k * stride);
+
+#pragma omp parallel
+    {
+        std::vector<PathBlockState<Real>> states(num_assets);
+        std::vector<Real> normals;
+        std::vector<Real> increments;
+        Real inverse_steps = Real(1) / static_cast<Real>(num_days);
+
+#pragma omp for schedule(static)
+        for (size_t b = 0; b < num_blocks; ++b)
+        {
+            size_t first = b * PATHS_PER_BLOCK;
+            size_t count = std::min(PATHS_PER_BLOCK, pairs - first);
+
+              // Every block of paths draws its shocks from its own stream
+            RandomStream stream(seed, b);
+            for (size_t i = 0; i < num_assets; ++i)
+                resetPathBlock(states[i], initial_prices[i]);
+
+            for (size_t first_step = 0; first_step < num_days; first_step += STEPS_PER_TILE)
+            {
+                size_t num_steps = std::min<size_t>(STEPS_PER_TILE, num_days - first_step);
+                shocks.generate(stream, num_steps, PATHS_PER_BLOCK, normals, increments);
+
+                for (size_t i = 0; i < num_assets; ++i)
+                    advancePathBlock(states[i], &increments[i * num_steps * PATHS_PER_BLOCK], num_steps, count, drifts[i]);
+            }
+
+              // Write the block in place in the columns of the assets
+            for (size_t i = 0; i < num_assets; ++i)
+            {
+                Real *final1   = columns[static_cast<size_t>(PathColumn::Final) * num_assets + i] + first;
+                Real *final2   = columns[static_cast<size_t>(PathColumn::AntitheticFinal) * num_assets + i] + first;
+                Real *average1 = columns[static_cast<size_t>(PathColumn::Average) * num_assets + i] + first;
+                Real *average2 = columns[static_cast<size_t>(PathColumn::AntitheticAverage) * num_assets + i] + first;
+#pragma omp simd
+                for (size_t p = 0; p < count; ++p)
+                {
+                    final1[p]   = states[i].price1[p];
+                    final2[p]   = states[i].price2[p];
+                    average1[p] = states[i].sum1[p] * inverse_steps;
+                    average2[p] = states[i].sum2[p] * inverse_steps;
+                }
+            }
+        }
+    }
+}
+
+  // Function to simulate paths and write them to a path store
+double writePathStore(const std::string &filename,
+                      size_t points,
+                      const std::vector<const Asset *> &assetPtrs,
+                      const Matrix &covariance_matrix,
+                      const PathPrecision &precision,
+                      uint64_t seed,
+                      PathStoreError &error)
+{
+      // Start the timer
+    auto start = std::chrono::high_resolution_clock::now();
+
+      // Calculate the Cholesky factorization of the covariance matrix, the store is written once per run
+    CholeskyError cholesky_error;
+    Matrix A = factorizeCovarianceMatrix(covariance_matrix, assetPtrs.size(), cholesky_error);
+    if (cholesky_error == CholeskyError::Failure)
+    {
+        error = PathStoreError::SimulationFailed;
+        return 0.0;
+    }
+
+    size_t num_assets = assetPtrs.size();
+    size_t pairs      = points / 2;
+
+    PathStoreHeader store_header;
+    std::memcpy(store_header.magic, PATH_STORE_MAGIC, sizeof(PATH_STORE_MAGIC));
+    store_header.version    = PATH_STORE_VERSION;
+    store_header.value_size = precision == PathPrecision::Single ? sizeof(float) : sizeof(double);
+    store_header.seed       = seed;
+    store_header.num_pairs  = pairs;
+    store_header.num_assets = static_cast<uint32_t>(num_assets);
+    store_header.num_days   = 252;
+    store_header.rate       = 0.05;
+    store_header.maturity   = 1.0;
+
+      // Create the file at its final size, the blocks write their columns in place
+    size_t num_columns = static_cast<size_t>(PathColumn::Count) * num_assets;
+    size_t file_size   = pathStoreDataOffset(num_assets) + num_columns * pathStoreColumnStride(pairs, store_header.value_size);
+    MappedFile file;
+    if (!file.create(filename, file_size))
+    {
+        std::cerr << "Could not create the path store " << filename << std::endl;
+        error = PathStoreError::FileOpenError;
+        return 0.0;
+    }
+
+      // Header, parameters of the assets and covariance matrix
+    unsigned char *data = file.data();
+    std::memcpy(data, &store_header, sizeof(PathStoreHeader));
+    for (size_t i = 0; i < num_assets; ++i)
+    {
+        PathStoreAsset store_asset;
+        std::memset(&store_asset, 0, sizeof(PathStoreAsset));
+        std::strncpy(store_asset.name, assetPtrs[i]->getName().c_str(), PATH_STORE_NAME_LENGTH - 1);
+        store_asset.initial_price  = assetPtrs[i]->getLastRealValue();
+        store_asset.return_mean    = assetPtrs[i]->getReturnMean();
+        store_asset.return_std_dev = assetPtrs[i]->getReturnStdDev();
+        std::memcpy(data + sizeof(PathStoreHeader) + i * sizeof(PathStoreAsset), &store_asset, sizeof(PathStoreAsset));
+    }
+    unsigned char *matrix = data + sizeof(PathStoreHeader) + num_assets * sizeof(PathStoreAsset);
+    for (size_t i = 0; i < num_assets; ++i)
+        std::memcpy(matrix + i * num_assets * sizeof(double), covariance_matrix.row(i), num_assets * sizeof(double));
+
+    if (precision == PathPrecision::Single)
+        writePathBlocks<float>(pairs, assetPtrs, A, seed, store_header, data);
+    else
+        writePathBlocks<double>(pairs, assetPtrs, A, seed, store_header, data);
+
+    file.close();
+    error = PathStoreError::Success;
+
+      // Stop the timer
+    auto end      = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    return static_cast<double>(duration.count());
+}
+
+  // Function to price the contracts of a book on the columns of a path store
+template <typename Real>
+static void repriceBlocks(const PathStore &store,
+                          const std::vector<OptionContract> &contracts,
+                          std::vector<RunningStatistics> &statistics)
+{
+    const PathStoreHeader &store_header = store.header();
+    size_t pairs      = store_header.num_pairs;
+    size_t num_assets = store_header.num_assets;
+    size_t num_blocks = (pairs + PATHS_PER_BLOCK - 1) / PATHS_PER_BLOCK;
+    double discount   = exp(-store_header.rate * store_header.maturity);
+
+    size_t num_contracts = contracts.size();
+    ContractArrays<Real> contract_arrays(contracts);
+
+      // Thread-local results, reduced in thread order after the parallel loop
+    size_t max_threads = static_cast<size_t>(omp_get_max_threads());
+    std::vector<std::vector<RunningStatistics>> thread_statistics(max_threads);
+
+#pragma omp parallel
+    {
+        std::vector<RunningStatistics> local_statistics(num_contracts);
+        BookBlockState<Real> book_block;
+        Real scale = static_cast<Real>(0.5 * discount);
+
+#pragma omp for schedule(static)
+        for (size_t b = 0; b < num_blocks; ++b)
+        {
+            size_t first = b * PATHS_PER_BLOCK;
+            size_t count = std::min(PATHS_PER_BLOCK, pairs - first);
+
+              // Final and average baskets of the pairs, summed from the columns of the assets,
+              // then the payoffs of all the contracts
+            resetBookBlock(book_block);
+            for (size_t i = 0; i < num_assets; ++i)
+            {
+                addToBookBlock(book_block,
+                               store.column<Real>(PathColumn::Final, i) + first,
+                               store.column<Real>(PathColumn::AntitheticFinal, i) + first,
+                               store.column<Real>(PathColumn::Average, i) + first,
+                               store.column<Real>(PathColumn::AntitheticAverage, i) + first,
+                               count, Real(1));
+            }
+            priceBookBlock(book_block, contract_arrays, count, scale, local_statistics);
+        }
+
+        size_t thread = static_cast<size_t>(omp_get_thread_num());
+        thread_statistics[thread] = std::move(local_statistics);
+    }
+
+      // Reduce the thread-local results once per call
+    for (size_t thread = 0; thread < max_threads; ++thread)
+    {
+        for (size_t c = 0; c < thread_statistics[thread].size(); ++c)
+            statistics[c].merge(thread_statistics[thread][c]);
+    }
+}
+
+  // Function to price a book of options on the paths of a path store
+double repricePathStore(const PathStore &store,
+                        const std::vector<OptionContract> &contracts,
+                        std::vector<RunningStatistics> &statistics)
+{
+    statistics.resize(contracts.size());
+
+      // Start the timer
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (store.header().value_size == sizeof(float))
+        repriceBlocks<float>(store, contracts, statistics);
+    else
+        repriceBlocks<double>(store, contracts, statistics);
+
+      // Stop the timer
+    auto end      = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    return static_cast<double>(duration.count());
+}
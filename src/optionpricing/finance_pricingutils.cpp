@@ -192,3 +192,223 @@ AssetCountType getAssetCountTypeFromUser()
 
     return assetCountType;
 }
+
+  // Function to get user input for the estimator of the Asian options
+Estimator getEstimatorFromUser()
+{
+    int       input     = 0;
+    Estimator estimator = Estimator::Invalid;
+
+      // Prompt user for input
+    std::cout << "\nSelect the estimator:\n1. Single level (every path on the 252 days)\n2. Multilevel (coupled coarse and fine grids, pseudo-random paths)\nEnter choice (1 or 2): ";
+
+      // Validate user input
+    while (true)
+    {
+        std::cin >> input;
+
+        if (std::cin.fail() || (input != 1 && input != 2))
+        {
+            std::cin.clear ();                                                   // Clear the error flag
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+            std::cout << "\nInvalid input. Please enter 1 for Single level or 2 for Multilevel." << std::endl;
+        }
+        else
+        {
+            estimator = static_cast<Estimator>(input);
+            break;
+        }
+    }
+
+    return estimator;
+}
+
+  // Function to get user input for the source of the paths of an option book
+PathSource getPathSourceFromUser()
+{
+    int        input  = 0;
+    PathSource source = PathSource::Invalid;
+
+      // Prompt user for input
+    std::cout << "\nSelect the source of the paths:\n1. Simulate\n2. Simulate and store the paths in data/paths.bin\n3. Stored paths of data/paths.bin (no simulation)\nEnter choice (1, 2 or 3): ";
+
+      // Validate user input
+    while (true)
+    {
+        std::cin >> input;
+
+        if (std::cin.fail() || input < 1 || input > 3)
+        {
+            std::cin.clear ();                                                   // Clear the error flag
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+            std::cout << "\nInvalid input. Please enter 1 to Simulate, 2 to Simulate and store or 3 for Stored paths." << std::endl;
+        }
+        else
+        {
+            source = static_cast<PathSource>(input);
+            break;
+        }
+    }
+
+    return source;
+}
+
+  // Function to get user input for the precision of the path kernel
+PathPrecision getPathPrecisionFromUser()
+{
+    int           input     = 0;
+    PathPrecision precision = PathPrecision::Invalid;
+
+      // Prompt user for input
+    std::cout << "\nSelect the precision of the path simulation:\n1. Double\n2. Single (faster, about 1e-5 relative error per path)\nEnter choice (1 or 2): ";
+
+      // Validate user input
+    while (true)
+    {
+        std::cin >> input;
+
+        if (std::cin.fail() || (input != 1 && input != 2))
+        {
+            std::cin.clear ();                                                   // Clear the error flag
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+            std::cout << "\nInvalid input. Please enter 1 for Double or 2 for Single." << std::endl;
+        }
+        else
+        {
+            precision = static_cast<PathPrecision>(input);
+            break;
+        }
+    }
+
+    return precision;
+}
+
+  // Function to get user input for the construction of the paths
+PathConstruction getPathConstructionFromUser()
+{
+    int              input        = 0;
+    PathConstruction construction = PathConstruction::Invalid;
+
+      // Prompt user for input
+    std::cout << "\nSelect the construction of the paths:\n1. Pseudo-random\n2. Brownian bridge with scrambled Sobol points (quasi-Monte Carlo)\nEnter choice (1 or 2): ";
+
+      // Validate user input
+    while (true)
+    {
+        std::cin >> input;
+
+        if (std::cin.fail() || (input != 1 && input != 2))
+        {
+            std::cin.clear ();                                                   // Clear the error flag
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+            std::cout << "\nInvalid input. Please enter 1 for Pseudo-random or 2 for Brownian bridge." << std::endl;
+        }
+        else
+        {
+            construction = static_cast<PathConstruction>(input);
+            break;
+        }
+    }
+
+    return construction;
+}
+
+  // Function to get user input for the variance reduction technique
+VarianceReduction getVarianceReductionFromUser()
+{
+    int               input     = 0;
+    VarianceReduction reduction = VarianceReduction::Invalid;
+
+      // Prompt user for input
+    std::cout << "\nSelect the variance reduction:\n1. None (antithetic paths only)\n2. Control variate (geometric Asian or final basket)\n3. Importance sampling (out-of-the-money strikes)\nEnter choice (1, 2 or 3): ";
+
+      // Validate user input
+    while (true)
+    {
+        std::cin >> input;
+
+        if (std::cin.fail() || input < 1 || input > 3)
+        {
+            std::cin.clear ();                                                   // Clear the error flag
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+            std::cout << "\nInvalid input. Please enter 1, 2 or 3." << std::endl;
+        }
+        else
+        {
+            reduction = static_cast<VarianceReduction>(input);
+            break;
+        }
+    }
+
+    return reduction;
+}
+
+  // Function to get user input for the strike as a multiple of the at-the-money strike
+double getStrikeMultiplierFromUser()
+{
+    double multiplier = 1.0;
+
+      // Prompt user for input
+    std::cout << "\nEnter the strike as a multiple of the at-the-money strike (e.g. 1.05): ";
+
+      // Validate user input
+    while (!(std::cin >> multiplier) || multiplier <= 0.0)
+    {
+        std::cin.clear ();                                                   // Clear the error flag
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+        std::cout << "\nInvalid input. Please enter a positive multiple." << std::endl;
+    }
+
+    return multiplier;
+}
+
+  // Function to get user input for the stopping rule
+StoppingRule getStoppingRuleFromUser(double &tolerance, size_t &max_simulations)
+{
+    int          input = 0;
+    StoppingRule rule  = StoppingRule::FixedPoints;
+
+      // Prompt user for input
+    std::cout << "\nSelect the stopping rule:\n1. Fixed number of simulations\n2. Absolute tolerance\n3. Relative tolerance\nEnter choice (1, 2 or 3): ";
+
+      // Validate user input
+    while (true)
+    {
+        std::cin >> input;
+
+        if (std::cin.fail() || input < 1 || input > 3)
+        {
+            std::cin.clear ();                                                   // Clear the error flag
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+            std::cout << "\nInvalid input. Please enter 1, 2 or 3." << std::endl;
+        }
+        else
+        {
+            rule = static_cast<StoppingRule>(input - 1);
+            break;
+        }
+    }
+
+    if (rule == StoppingRule::FixedPoints)
+        return rule;
+
+      // Prompt user for the tolerance of the 95% confidence interval half-width
+    std::cout << "\nEnter the tolerance of the 95% confidence interval half-width: ";
+    while (!(std::cin >> tolerance) || tolerance <= 0.0)
+    {
+        std::cin.clear ();                                                   // Clear the error flag
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+        std::cout << "\nInvalid input. Please enter a positive tolerance." << std::endl;
+    }
+
+      // Prompt user for the maximum number of simulations
+    std::cout << "\nEnter the maximum number of simulations: ";
+    while (!(std::cin >> max_simulations) || max_simulations < 2)
+    {
+        std::cin.clear ();                                                   // Clear the error flag
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+        std::cout << "\nInvalid input. Please enter at least 2 simulations." << std::endl;
+    }
+
+    return rule;
+}
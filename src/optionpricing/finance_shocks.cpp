@@ -0,0 +1,63 @@
+#include "../../include/optionpricing/finance_shocks.hpp"
+
+  // Constructor: pack the lower triangle of the factor row by row, scaled by sqrt(dt)
+template <typename T>
+CorrelatedShocks<T>::CorrelatedShocks(const Matrix &cholesky_factor, double dt)
+    :  num_assets(cholesky_factor.rows()), factor(cholesky_factor, std::sqrt(dt))
+{
+}
+
+  // Function to generate the correlated increments of a tile of steps of a block of paths
+template <typename T>
+void CorrelatedShocks<T>::generate(RandomStream &stream, size_t num_steps, size_t paths, std::vector<T> &normals, std::vector<T> &increments) const
+{
+    normals.resize(num_assets * num_steps * paths);
+
+      // Fresh independent normals for every asset, step and path, drawn
+      // directly in the precision of the paths
+    stream.fillNormal(normals.data(), normals.size());
+
+    correlate(num_steps, paths, normals, increments);
+}
+
+  // Function to apply the scaled Cholesky factor to the normals of a tile of steps of a block of paths
+template <typename T>
+void CorrelatedShocks<T>::correlate(size_t num_steps, size_t paths, const std::vector<T> &normals, std::vector<T> &increments) const
+{
+    size_t row = num_steps * paths;
+    increments.resize(num_assets * row);
+
+    alignas(64) T tile[SHOCK_TILE];
+
+      // Lower-triangular product, one tile of columns at a time
+    for (size_t first = 0; first < row; first += SHOCK_TILE)
+    {
+        size_t length = std::min(SHOCK_TILE, row - first);
+
+        for (size_t i = 0; i < num_assets; ++i)
+        {
+            const double *l = factor.row(i);
+            const T *z = &normals[first];
+            T diagonal = static_cast<T>(l[0]);
+
+#pragma omp simd
+            for (size_t c = 0; c < length; ++c)
+                tile[c] = diagonal * z[c];
+
+            for (size_t k = 1; k <= i; ++k)
+            {
+                z = &normals[k * row + first];
+                T weight = static_cast<T>(l[k]);
+#pragma omp simd
+                for (size_t c = 0; c < length; ++c)
+                    tile[c] += weight * z[c];
+            }
+
+            std::copy(tile, tile + length, &increments[i * row + first]);
+        }
+    }
+}
+
+  // Instantiations used by the pricing kernels
+template class CorrelatedShocks<float>;
+template class CorrelatedShocks<double>;
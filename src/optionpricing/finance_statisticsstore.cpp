@@ -0,0 +1,321 @@
+#include "../../include/optionpricing/finance_statisticsstore.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+
+#include "../../include/optionpricing/finance_mappedfile.hpp"
+#include "../../include/optionpricing/finance_montecarloutils.hpp"
+
+  // Header of the file of a statistics store
+struct StatisticsStoreHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t num_assets;
+    uint64_t count;
+};
+
+  // Offset basis and prime of the 64-bit FNV-1a hash of the fingerprints
+constexpr uint64_t FINGERPRINT_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr uint64_t FINGERPRINT_PRIME        = 1099511628211ULL;
+
+  // Function to continue the fingerprint of the returns of an asset with the days from first to last,
+  // one byte of the bits of every return at a time
+static uint64_t fingerprintReturns(uint64_t fingerprint, const Asset *asset, size_t first, size_t last)
+{
+    for (size_t t = first; t < last; ++t)
+    {
+        double value = asset->getDailyReturn(t);
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (size_t byte = 0; byte < sizeof(bits); ++byte)
+            fingerprint = (fingerprint ^ ((bits >> (8 * byte)) & 0xff)) * FINGERPRINT_PRIME;
+    }
+    return fingerprint;
+}
+
+  // Function to build the statistics from the whole history of the assets
+StatisticsStoreError AssetStatisticsStore::build(const std::vector<const Asset *> &assetPtrs)
+{
+    CovarianceError cov_error;
+    Matrix covariance_matrix = calculateCovarianceMatrix(assetPtrs, cov_error);
+    if (cov_error != CovarianceError::Success || assetPtrs.empty())
+        return StatisticsStoreError::CovarianceFailure;
+
+    size_t num_assets = assetPtrs.size();
+    count = assetPtrs[0]->getDailyReturnsSize();
+    names.resize(num_assets);
+    fingerprints.resize(num_assets);
+    means.resize(num_assets);
+    comoments.assign(num_assets * (num_assets + 1) / 2, 0.0);
+
+      // The co-moments are the covariances times n - 1
+    for (size_t i = 0; i < num_assets; ++i)
+    {
+        names[i]        = assetPtrs[i]->getName();
+        fingerprints[i] = fingerprintReturns(FINGERPRINT_OFFSET_BASIS, assetPtrs[i], 0, count);
+        means[i]        = assetPtrs[i]->getReturnMean();
+        for (size_t j = 0; j <= i; ++j)
+            comoments[packedIndex(i, j)] = covariance_matrix(i, j) * static_cast<double>(count - 1);
+    }
+
+    return StatisticsStoreError::Success;
+}
+
+  // Function to add one day of returns with the multivariate Welford update
+void AssetStatisticsStore::addReturns(const double *daily_returns)
+{
+    size_t num_assets = means.size();
+    std::vector<double> deltas(num_assets);
+
+    ++count;
+    double weight = static_cast<double>(count - 1) / static_cast<double>(count);
+    for (size_t i = 0; i < num_assets; ++i)
+    {
+        deltas[i]  = daily_returns[i] - means[i];
+        means[i]  += deltas[i] / static_cast<double>(count);
+    }
+
+      // Row i of the packed lower triangle
+    for (size_t i = 0; i < num_assets; ++i)
+    {
+        double *row         = &comoments[i * (i + 1) / 2];
+        double scaled_delta = weight * deltas[i];
+#pragma omp simd
+        for (size_t j = 0; j <= i; ++j)
+            row[j] += scaled_delta * deltas[j];
+    }
+}
+
+  // Function to bring the statistics up to date with the returns of the assets
+StatisticsStoreError AssetStatisticsStore::synchronize(const std::vector<const Asset *> &assetPtrs, size_t &added_days, bool &rebuilt)
+{
+    size_t num_assets = assetPtrs.size();
+    added_days = 0;
+    rebuilt    = false;
+
+      // Position in the store of every asset
+    std::vector<size_t> positions(num_assets, names.size());
+    bool same_assets = count > 0 && names.size() == num_assets;
+    for (size_t k = 0; k < num_assets && same_assets; ++k)
+    {
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            if (names[i] == assetPtrs[k]->getName())
+                positions[k] = i;
+        }
+        same_assets = positions[k] < names.size();
+    }
+
+    size_t num_days = num_assets > 0 ? assetPtrs[0]->getDailyReturnsSize() : 0;
+    for (const Asset *asset : assetPtrs)
+    {
+        if (asset->getDailyReturnsSize() != num_days)
+            return StatisticsStoreError::CovarianceFailure;
+    }
+
+      // The days of the store must still be the first days of the history
+    bool same_history = same_assets && num_days >= count && fingerprints.size() == names.size();
+    for (size_t k = 0; k < num_assets && same_history; ++k)
+        same_history = fingerprintReturns(FINGERPRINT_OFFSET_BASIS, assetPtrs[k], 0, count) == fingerprints[positions[k]];
+
+      // Build the statistics again for other assets or another history
+    if (!same_history)
+    {
+        StatisticsStoreError build_error = build(assetPtrs);
+        added_days = count;
+        rebuilt    = true;
+        return build_error;
+    }
+
+      // Permute the store to the order of the assets
+    std::vector<std::string> permuted_names(num_assets);
+    std::vector<uint64_t> permuted_fingerprints(num_assets);
+    std::vector<double> permuted_means(num_assets);
+    std::vector<double> permuted_comoments(comoments.size());
+    for (size_t k = 0; k < num_assets; ++k)
+    {
+        permuted_names[k]        = names[positions[k]];
+        permuted_fingerprints[k] = fingerprints[positions[k]];
+        permuted_means[k]        = means[positions[k]];
+        for (size_t l = 0; l <= k; ++l)
+            permuted_comoments[packedIndex(k, l)] = comoments[packedIndex(positions[k], positions[l])];
+    }
+    names        = std::move(permuted_names);
+    fingerprints = std::move(permuted_fingerprints);
+    means        = std::move(permuted_means);
+    comoments    = std::move(permuted_comoments);
+
+      // Add only the new days, the fingerprints go on from the days of the store
+    size_t first_new_day = count;
+    std::vector<double> daily_returns(num_assets);
+    for (size_t t = first_new_day; t < num_days; ++t)
+    {
+        for (size_t k = 0; k < num_assets; ++k)
+            daily_returns[k] = assetPtrs[k]->getDailyReturn(t);
+        addReturns(daily_returns.data());
+        ++added_days;
+    }
+    for (size_t k = 0; k < num_assets; ++k)
+        fingerprints[k] = fingerprintReturns(fingerprints[k], assetPtrs[k], first_new_day, num_days);
+
+    return StatisticsStoreError::Success;
+}
+
+  // Function to load the store from a file
+StatisticsStoreError AssetStatisticsStore::load(const std::string &filename)
+{
+    MappedFile file;
+    if (!file.openRead(filename))
+        return StatisticsStoreError::FileOpenError;
+
+      // Check the header before reading anything it points to
+    const StatisticsStoreHeader *header = reinterpret_cast<const StatisticsStoreHeader *>(file.data());
+    if (file.size() < sizeof(StatisticsStoreHeader)
+        || std::memcmp(header->magic, STATISTICS_STORE_MAGIC, sizeof(STATISTICS_STORE_MAGIC)) != 0
+        || header->version != STATISTICS_STORE_VERSION)
+    {
+        return StatisticsStoreError::InvalidFormat;
+    }
+
+    size_t num_assets          = header->num_assets;
+    size_t num_comoments       = num_assets * (num_assets + 1) / 2;
+    size_t fingerprints_offset = sizeof(StatisticsStoreHeader);
+    size_t means_offset        = fingerprints_offset + num_assets * sizeof(uint64_t);
+    size_t packed_offset       = means_offset + num_assets * sizeof(double);
+    size_t names_offset        = packed_offset + num_comoments * sizeof(double);
+    if (file.size() < names_offset)
+        return StatisticsStoreError::InvalidFormat;
+
+      // Names of the assets, each one after its length
+    std::vector<std::string> loaded_names(num_assets);
+    size_t offset = names_offset;
+    for (size_t i = 0; i < num_assets; ++i)
+    {
+        uint32_t length;
+        if (file.size() - offset < sizeof(length))
+            return StatisticsStoreError::InvalidFormat;
+        std::memcpy(&length, file.data() + offset, sizeof(length));
+        offset += sizeof(length);
+        if (file.size() - offset < length)
+            return StatisticsStoreError::InvalidFormat;
+        loaded_names[i].assign(reinterpret_cast<const char *>(file.data() + offset), length);
+        offset += length;
+    }
+
+    count = header->count;
+    names = std::move(loaded_names);
+    fingerprints.resize(num_assets);
+    means.resize(num_assets);
+    comoments.resize(num_comoments);
+    std::memcpy(fingerprints.data(), file.data() + fingerprints_offset, num_assets * sizeof(uint64_t));
+    std::memcpy(means.data(), file.data() + means_offset, num_assets * sizeof(double));
+    std::memcpy(comoments.data(), file.data() + packed_offset, num_comoments * sizeof(double));
+
+    return StatisticsStoreError::Success;
+}
+
+  // Function to save the store to a file
+StatisticsStoreError AssetStatisticsStore::save(const std::string &filename) const
+{
+    size_t num_assets          = names.size();
+    size_t fingerprints_offset = sizeof(StatisticsStoreHeader);
+    size_t means_offset        = fingerprints_offset + num_assets * sizeof(uint64_t);
+    size_t packed_offset       = means_offset + num_assets * sizeof(double);
+    size_t names_offset        = packed_offset + comoments.size() * sizeof(double);
+    size_t size                = names_offset;
+    for (const std::string &name : names)
+        size += sizeof(uint32_t) + name.size();
+
+    MappedFile file;
+    if (!file.create(filename, size))
+        return StatisticsStoreError::FileOpenError;
+
+    StatisticsStoreHeader header;
+    std::memcpy(header.magic, STATISTICS_STORE_MAGIC, sizeof(STATISTICS_STORE_MAGIC));
+    header.version    = STATISTICS_STORE_VERSION;
+    header.num_assets = static_cast<uint32_t>(num_assets);
+    header.count      = count;
+
+    unsigned char *data = file.data();
+    std::memcpy(data, &header, sizeof(StatisticsStoreHeader));
+    std::memcpy(data + fingerprints_offset, fingerprints.data(), num_assets * sizeof(uint64_t));
+    std::memcpy(data + means_offset, means.data(), num_assets * sizeof(double));
+    std::memcpy(data + packed_offset, comoments.data(), comoments.size() * sizeof(double));
+
+    size_t offset = names_offset;
+    for (const std::string &name : names)
+    {
+        uint32_t length = static_cast<uint32_t>(name.size());
+        std::memcpy(data + offset, &length, sizeof(length));
+        std::memcpy(data + offset + sizeof(length), name.data(), name.size());
+        offset += sizeof(length) + name.size();
+    }
+
+    return StatisticsStoreError::Success;
+}
+
+  // Function to get the standard deviation of the returns of an asset
+double AssetStatisticsStore::getStdDev(size_t i) const
+{
+    return count > 0 ? std::sqrt(comoments[packedIndex(i, i)] / static_cast<double>(count)) : 0.0;
+}
+
+  // Function to get the covariance of the returns of two assets
+double AssetStatisticsStore::getCovariance(size_t i, size_t j) const
+{
+    return count > 1 ? comoments[packedIndex(i, j)] / static_cast<double>(count - 1) : 0.0;
+}
+
+  // Function to get the covariance matrix of the returns of the assets
+Matrix AssetStatisticsStore::covarianceMatrix() const
+{
+    size_t num_assets = names.size();
+    Matrix covariance_matrix(num_assets, num_assets);
+    for (size_t i = 0; i < num_assets; ++i)
+    {
+        for (size_t j = 0; j <= i; ++j)
+        {
+            covariance_matrix(i, j) = getCovariance(i, j);
+            covariance_matrix(j, i) = covariance_matrix(i, j);
+        }
+    }
+
+    return covariance_matrix;
+}
+
+  // Function to update the statistics store of a directory of assets
+StatisticsStoreError updateStatisticsStore(const std::string &directory,
+                                           std::vector<Asset> &assets,
+                                           AssetStatisticsStore &store,
+                                           size_t &added_days,
+                                           bool &rebuilt)
+{
+    std::string filename = (std::filesystem::path(directory) / STATISTICS_STORE_FILENAME).string();
+
+      // A missing or invalid store is built again by the synchronization
+    store.load(filename);
+
+    std::vector<const Asset *> assetPtrs;
+    assetPtrs.reserve(assets.size());
+    for (const auto &asset : assets)
+        assetPtrs.emplace_back(&asset);
+
+    StatisticsStoreError error = store.synchronize(assetPtrs, added_days, rebuilt);
+    if (error != StatisticsStoreError::Success)
+        return error;
+
+    error = store.save(filename);
+    if (error != StatisticsStoreError::Success)
+        return error;
+
+      // The store is in the order of the assets
+    for (size_t i = 0; i < assets.size(); ++i)
+    {
+        assets[i].setReturnMean(store.getMean(i));
+        assets[i].setReturnStdDev(store.getStdDev(i));
+    }
+
+    return StatisticsStoreError::Success;
+}
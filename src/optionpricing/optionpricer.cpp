@@ -1,5 +1,117 @@
 #include "../../include/optionpricing/optionpricer.hpp"
 
+  // Function to update the persisted statistics of the returns of the assets with the
+  // days added to their files since the last run, the covariance matrix of the returns
+  // is the one of the store, or the one of the files if the store could not be updated
+static Matrix updateAssetStatistics(std::vector<Asset> &assets, const AssetCountType &asset_count_type)
+{
+    AssetStatisticsStore store;
+    size_t added_days = 0;
+    bool rebuilt      = false;
+
+    StatisticsStoreError error = updateStatisticsStore("../data/" + assetSubdirectory(asset_count_type), assets, store, added_days, rebuilt);
+    if (error != StatisticsStoreError::Success)
+    {
+        std::cout << "The statistics store could not be updated, the statistics of the files are used.\n"
+                  << std::endl;
+
+        std::vector<const Asset *> assetPtrs;
+        for (const auto &asset : assets)
+            assetPtrs.emplace_back(&asset);
+
+        CovarianceError cov_error;
+        Matrix covariance_matrix = calculateCovarianceMatrix(assetPtrs, cov_error);
+        if (cov_error != CovarianceError::Success)
+        {
+            std::cerr << "Error calculating the covariance matrix" << std::endl;
+            exit(1);
+        }
+        return covariance_matrix;
+    }
+
+    if (rebuilt)
+        std::cout << "The statistics store has been built from " << added_days << " days.\n"
+                  << std::endl;
+    else
+        std::cout << "The statistics store has been updated with " << added_days << " new days.\n"
+                  << std::endl;
+
+      // The store is in the order of the assets
+    return store.covarianceMatrix();
+}
+
+  // Function to compute the price of an Asian option with the multilevel estimator,
+  // print the samples of every level and the cost compared to the single level estimator
+static void multilevelComputation(const std::vector<Asset> &assets,
+                                  const std::vector<const Asset *> &assetPtrs,
+                                  const Matrix &cholesky_factor,
+                                  double strike_price,
+                                  const PathPrecision &precision,
+                                  StoppingRule stopping_rule,
+                                  double tolerance,
+                                  size_t points,
+                                  size_t max_simulations,
+                                  uint64_t seed,
+                                  const std::string &function)
+{
+    std::vector<MultilevelLevel> levels;
+    std::vector<double> predicted_assets_prices(assets.size(), 0.0);
+    double standard_error = 0.0;
+    MonteCarloError error;
+
+    std::cout << "Calculating the price of the option with the multilevel estimator...\n"
+              << std::endl;
+
+    size_t max_points = stopping_rule == StoppingRule::FixedPoints ? points : max_simulations;
+    std::pair<double, double> result = multilevelPricePrediction(assetPtrs, cholesky_factor, strike_price, precision, stopping_rule, tolerance, points, max_points,
+                                                                 seed, levels, standard_error, predicted_assets_prices, error);
+    if (error != MonteCarloError::Success)
+    {
+        std::cerr << "Error in Monte Carlo simulation" << std::endl;
+        exit(1);
+    }
+
+      // Samples of the levels, the cost is counted in simulated steps
+    size_t used_simulations = 0;
+    double cost             = 0.0;
+    std::cout << "Level   Steps       Pairs   Mean of the correction      Variance" << std::endl;
+    for (size_t l = 0; l < levels.size(); ++l)
+    {
+        const RunningStatistics &correction = levels[l].correction;
+        std::cout << std::setw(5) << l << std::setw(8) << levels[l].num_steps << std::setw(12) << correction.getCount()
+                  << std::setw(25) << correction.getMean() << std::setw(14) << correction.getVariance() << std::endl;
+        used_simulations += 2 * correction.getCount();
+        cost             += 2.0 * static_cast<double>(correction.getCount()) * static_cast<double>(levels[l].num_steps);
+    }
+
+      // Steps the single level estimator needs for the same standard error, from the
+      // variance of the payoffs on the finest grid
+    const MultilevelLevel &finest = levels.back();
+    double single_level_cost = standard_error > 0.0
+                                   ? 2.0 * finest.fine.getVariance() / (standard_error * standard_error) * static_cast<double>(finest.num_steps)
+                                   : 0.0;
+
+    std::cout << "\nThe option expected payoff calculated via multilevel Monte Carlo method is " << result.first << std::endl;
+
+      // Write results to file
+    writeResultsToFile(assets, result, standard_error, function, used_simulations, OptionType::Asian);
+
+    std::cout << "Seed: " << seed << std::endl;
+    std::cout << "95% confidence interval: [" << result.first - 1.96 * standard_error << ", " << result.first + 1.96 * standard_error << "]" << std::endl;
+    std::cout << "Simulated steps: " << cost << ", the single level estimator needs about " << single_level_cost
+              << " for the same standard error (" << single_level_cost / cost << " times more)" << std::endl;
+    if (stopping_rule != StoppingRule::FixedPoints && !targetPrecisionReached(result.first, standard_error, stopping_rule, tolerance))
+        std::cout << "Warning: the maximum number of points was reached before the target precision." << std::endl;
+    std::cout << "\nThe results have been saved to output.txt\n"
+              << std::endl;
+
+      // Output predicted future prices of assets
+    for (size_t i = 0; i < assets.size(); ++i)
+    {
+        std::cout << "The predicted future prices (one year) of one " << assets[i].getName() << " stock is " << predicted_assets_prices[i] << std::endl;
+    }
+}
+
   // Function that embeds multiple methods used to compute
   // the option price using the Monte Carlo method
 void financeComputation()
@@ -23,6 +135,54 @@ void financeComputation()
         exit(1);
     }
 
+      // The multilevel estimator refines the grid of the days of the Asian options
+    Estimator estimator = Estimator::SingleLevel;
+    if (option_type == OptionType::Asian)
+    {
+        estimator = getEstimatorFromUser();
+        if (estimator == Estimator::Invalid)
+        {
+            std::cerr << "\nInvalid estimator" << std::endl;
+            exit(1);
+        }
+    }
+    bool multilevel = estimator == Estimator::Multilevel;
+
+      // Get the precision of the path kernel from user input
+    PathPrecision precision = getPathPrecisionFromUser();
+    if (precision == PathPrecision::Invalid)
+    {
+        std::cerr << "\nInvalid precision" << std::endl;
+        exit(1);
+    }
+
+      // Get the construction of the paths from user input, the multilevel
+      // estimator uses pseudo-random paths without variance reduction
+    PathConstruction construction = multilevel ? PathConstruction::PseudoRandom : getPathConstructionFromUser();
+    if (construction == PathConstruction::Invalid)
+    {
+        std::cerr << "\nInvalid path construction" << std::endl;
+        exit(1);
+    }
+
+      // Get the variance reduction from user input
+    VarianceReduction variance_reduction = multilevel ? VarianceReduction::None : getVarianceReductionFromUser();
+    if (variance_reduction == VarianceReduction::Invalid)
+    {
+        std::cerr << "\nInvalid variance reduction" << std::endl;
+        exit(1);
+    }
+
+      // The importance sampling is meant for the strikes far from the money
+    double strike_multiplier = 1.0;
+    if (variance_reduction == VarianceReduction::ImportanceSampling)
+        strike_multiplier = getStrikeMultiplierFromUser();
+
+      // Get the stopping rule from user input
+    double tolerance       = 0.0;
+    size_t max_simulations = 0;
+    StoppingRule stopping_rule = getStoppingRuleFromUser(tolerance, max_simulations);
+
       // Load the assets from the CSV files
     std::cout << "\nLoading assets from csv..." << std::endl;
 
@@ -43,6 +203,15 @@ void financeComputation()
         exit(1);
     }
 
+      // Add the new days of the files to the statistics of the assets
+    Matrix covariance_matrix = updateAssetStatistics(assets, asset_count_type);
+
+      // Factorize the covariance matrix once for all the iterations
+    CholeskyError cholesky_error;
+    Matrix cholesky_factor = factorizeCovarianceMatrix(covariance_matrix, assets.size(), cholesky_error);
+    if (cholesky_error == CholeskyError::Failure)
+        exit(1);
+
       // Create a vector of pointers to assets for Monte Carlo computation
     std::vector<const Asset *> assetPtrs;
     assetPtrs.reserve(assets.size());
@@ -54,15 +223,23 @@ void financeComputation()
       // Set the number of iterations and simulations based on the option type
     size_t num_iterations  = 10;
     size_t num_simulations = (option_type == OptionType::European) ? 1e6 : 1e5;
-    double strike_price    = calculateStrikePrice(assets);
-    double variance        = 0.0;
-    double variance_temp   = 0.0;
+    size_t used_simulations = 0;
+    double strike_price    = calculateStrikePrice(assets) * strike_multiplier;
     double standard_error  = 0.0;
+    RunningStatistics statistics;
     std::pair<double, double> result;
     std::pair<double, double> result_temp;
     result.first  = 0.0;
     result.second = 0.0;
     MonteCarloError error;
+    double variance_ratio     = 1.0;
+    double variance_ratio_sum = 0.0;
+    std::vector<double> importance_shift;
+    GreekStatistics greeks;
+
+      // Seed of the random streams, every iteration uses the next one
+    std::random_device rd;
+    uint64_t seed = (static_cast<uint64_t>(rd()) << 32) | rd();
 
       // Create the payoff function and coefficients
     auto function_pair = createPayoffFunction(strike_price, assets);
@@ -73,18 +250,45 @@ void financeComputation()
     std::vector<double> predicted_assets_prices;
     predicted_assets_prices.resize(assets.size());
 
+    if (multilevel)
+    {
+        multilevelComputation(assets, assetPtrs, cholesky_factor, strike_price, precision, stopping_rule, tolerance,
+                              num_iterations * num_simulations, max_simulations, seed, function);
+        return;
+    }
+
     std::cout << "Calculating the price of the option...\n"
               << std::endl;
 
-      // Apply the Monte Carlo method to calculate the price of the option
+      // Apply the Monte Carlo method to calculate the price of the option,
+      // the statistics of every iteration are merged into the running statistics.
+      // With the Brownian bridge construction every iteration is one randomization
+      // of the Sobol sequence and one sample, so the rounds keep the same size and
+      // at least four of them are needed for the standard error
+    bool quasi_random        = construction == PathConstruction::BrownianBridgeSobol;
+    size_t min_rounds        = quasi_random ? 4 : 2;
+    size_t round_simulations = num_simulations;
+    if (stopping_rule != StoppingRule::FixedPoints)
+        num_iterations = max_simulations / 2;
     for (size_t j = 0; j < num_iterations; ++j)
     {
-        result_temp = monteCarloPricePrediction(num_simulations,
+        if (stopping_rule != StoppingRule::FixedPoints)
+            round_simulations = std::min(round_simulations, max_simulations - used_simulations);
+
+        result_temp = monteCarloPricePrediction(round_simulations,
                                                 assetPtrs,
-                                                variance_temp,
+                                                cholesky_factor,
+                                                statistics,
                                                 strike_price,
                                                 predicted_assets_prices,
                                                 option_type,
+                                                precision,
+                                                construction,
+                                                variance_reduction,
+                                                importance_shift,
+                                                variance_ratio,
+                                                &greeks,
+                                                seed + j,
                                                 error);
 
         if (error != MonteCarloError::Success)
@@ -93,24 +297,49 @@ void financeComputation()
             exit(1);
         }
 
-        result.first   += result_temp.first;
-        result.second  += result_temp.second;
-        variance       += variance_temp;
-        standard_error += std::sqrt(variance_temp / static_cast<double>(num_simulations));
+        result.second      += result_temp.second;
+        variance_ratio_sum += variance_ratio * static_cast<double>(round_simulations);
+        used_simulations   += round_simulations;
+        result.first      = statistics.getMean();
+        standard_error    = statistics.getStandardError();
 
-        double progress = static_cast<double>(j + 1) / static_cast<double>(num_iterations) * 100;
-        std::cout << "Process at " << progress << "% ..." << std::endl;
-    }
+          // Unbiased spread of the few randomizations
+        if (quasi_random && statistics.getCount() > 1)
+            standard_error *= std::sqrt(static_cast<double>(statistics.getCount()) / static_cast<double>(statistics.getCount() - 1));
 
-      // Calculate averages
-    result.first   /= num_iterations;
-    variance       /= num_iterations;
-    standard_error /= num_iterations;
+        if (stopping_rule == StoppingRule::FixedPoints)
+        {
+            double progress = static_cast<double>(j + 1) / static_cast<double>(num_iterations) * 100;
+            std::cout << "Process at " << progress << "% ..." << std::endl;
+            continue;
+        }
+
+          // A zero payoff of every path has no precision
+        bool resolved = statistics.getMean() != 0.0 || statistics.getVariance() > 0.0;
+        if (resolved)
+            std::cout << "Round " << j + 1 << ": " << used_simulations << " simulations, payoff " << result.first
+                      << " +/- " << 1.96 * standard_error << std::endl;
+        else
+            std::cout << "Round " << j + 1 << ": " << used_simulations << " simulations, no path in the exercise region" << std::endl;
+
+          // Stop at the target precision, after the minimum number of rounds, or at the maximum
+        if ((j + 1 >= min_rounds && resolved && targetPrecisionReached(result.first, standard_error, stopping_rule, tolerance)) || used_simulations + 2 > max_simulations)
+        {
+            num_iterations = j + 1;
+            break;
+        }
+
+          // Predict the size of the next round from the current standard error, in antithetic pairs
+        if (quasi_random)
+            continue;
+        round_simulations = 2 * nextRoundSize(used_simulations / 2, max_simulations / 2, result.first, standard_error,
+                                              stopping_rule, tolerance, num_simulations / 2);
+    }
 
       // Normalize predicted asset prices
     for (size_t i = 0; i < assetPtrs.size(); ++i)
     {
-        predicted_assets_prices[i] /= (num_iterations * num_simulations);
+        predicted_assets_prices[i] /= used_simulations;
     }
 
       // Output option price calculated via Black-Scholes model if applicable
@@ -125,11 +354,55 @@ void financeComputation()
     std::cout << "The option expected payoff calculated via Monte Carlo method is " << result.first << std::endl;
 
       // Write results to file
-    writeResultsToFile(assets, result, standard_error, function, num_simulations, option_type);
+    writeResultsToFile(assets, result, standard_error, function, used_simulations, option_type);
 
       // Output information about the calculation
-    std::cout << "\nThe integral has been calculated successfully " << num_iterations << " times for " << num_simulations << " points." << std::endl;
-    std::cout << "The resulting expected discounted option payoff is the average of the " << num_iterations << " iterations.\n";
+    std::cout << "Seed: " << seed << std::endl;
+
+      // Without any path in the exercise region the samples are all zero, and so would be
+      // the width of the confidence interval and the Greeks
+    bool resolved = statistics.getMean() != 0.0 || statistics.getVariance() > 0.0;
+    if (resolved)
+        std::cout << "95% confidence interval: [" << result.first - 1.96 * standard_error << ", " << result.first + 1.96 * standard_error << "]" << std::endl;
+    else
+        std::cout << "Warning: no simulated path ended in the exercise region, the expected payoff and the Greeks are unresolved." << std::endl;
+
+      // Output the Greeks, from the same paths as the price
+    auto half_width = [&](const RunningStatistics &greek)
+    {
+        double greek_error = greek.getStandardError();
+        if (quasi_random && greek.getCount() > 1)
+            greek_error *= std::sqrt(static_cast<double>(greek.getCount()) / static_cast<double>(greek.getCount() - 1));
+        return 1.96 * greek_error;
+    };
+    if (resolved)
+    {
+        std::cout << "\nGreeks of the expected discounted payoff (+/- 95% confidence interval half-width):" << std::endl;
+        for (size_t i = 0; i < assets.size(); ++i)
+            std::cout << "Delta (" << assets[i].getName() << "): " << greeks.delta[i].getMean() << " +/- " << half_width(greeks.delta[i]) << std::endl;
+        for (size_t i = 0; i < assets.size(); ++i)
+            std::cout << "Gamma (" << assets[i].getName() << "): " << greeks.gamma[i].getMean() << " +/- " << half_width(greeks.gamma[i]) << std::endl;
+        std::cout << "Vega (same shift of all the volatilities): " << greeks.vega.getMean() << " +/- " << half_width(greeks.vega) << std::endl;
+        std::cout << "Rho: " << greeks.rho.getMean() << " +/- " << half_width(greeks.rho) << "\n" << std::endl;
+    }
+
+    if (variance_reduction == VarianceReduction::ControlVariate)
+    {
+        double factor = variance_ratio_sum / static_cast<double>(used_simulations);
+        std::cout << "Variance reduction factor of the control variate: " << factor
+                  << " (the same precision needs " << factor << " times fewer simulations)" << std::endl;
+    }
+    if (stopping_rule == StoppingRule::FixedPoints)
+    {
+        std::cout << "\nThe integral has been calculated successfully " << num_iterations << " times for " << num_simulations << " points." << std::endl;
+        std::cout << "The resulting expected discounted option payoff is the average of the " << num_iterations << " iterations.\n";
+    }
+    else
+    {
+        std::cout << "\nThe integral has been calculated in " << num_iterations << " rounds with " << used_simulations << " points (maximum " << max_simulations << ")." << std::endl;
+        if (resolved && !targetPrecisionReached(result.first, standard_error, stopping_rule, tolerance))
+            std::cout << "Warning: the maximum number of points was reached before the target precision." << std::endl;
+    }
     std::cout << "\nThe results have been saved to output.txt\n"
               << std::endl;
 
@@ -139,3 +412,195 @@ void financeComputation()
         std::cout << "The predicted future prices (one year) of one " << assets[i].getName() << " stock is " << predicted_assets_prices[i] << std::endl;
     }
 }
+
+  // Function to load the contracts of the book, their strikes are multiples of the at-the-money strike
+static void loadBookContracts(double at_the_money_strike, std::vector<OptionContract> &contracts)
+{
+    LoadBookError book_result = loadOptionBook("../data/book.csv", at_the_money_strike, contracts);
+    switch (book_result)
+    {
+    case LoadBookError::Success: 
+        std::cout << "The book of " << contracts.size() << " contracts has been loaded successfully.\n"
+                  << std::endl;
+        break;
+    case LoadBookError::NoContracts: 
+        std::cout << "No contracts found in the book\n"
+                  << std::endl;
+        exit(1);
+    case LoadBookError::FileOpenError: 
+    case LoadBookError::InvalidLine: 
+        exit(1);
+    }
+}
+
+  // Function to print the price of every contract of the book
+static void printBookPrices(const std::vector<OptionContract> &contracts, const std::vector<RunningStatistics> &statistics)
+{
+    std::cout << "\n      Strike        Type  Payoff  Expected discounted payoff  95% half-width" << std::endl;
+    for (size_t c = 0; c < contracts.size(); ++c)
+    {
+        std::cout << std::setw(12) << contracts[c].strike_price
+                  << std::setw(12) << (contracts[c].option_type == OptionType::Asian ? "Asian" : "European")
+                  << std::setw(8) << (contracts[c].payoff_type == PayoffType::Put ? "Put" : "Call")
+                  << std::setw(28) << statistics[c].getMean()
+                  << std::setw(16) << 1.96 * statistics[c].getStandardError() << std::endl;
+    }
+}
+
+  // Function to price a book of option contracts on the same simulated paths,
+  // or on the paths of a path store
+void bookComputation()
+{
+    const std::string store_filename = "../data/paths.bin";
+    std::vector<OptionContract> contracts;
+    std::vector<RunningStatistics> statistics;
+
+      // Get the source of the paths from user input
+    PathSource source = getPathSourceFromUser();
+    if (source == PathSource::Invalid)
+    {
+        std::cerr << "\nInvalid path source" << std::endl;
+        exit(1);
+    }
+
+      // The stored paths carry the parameters of the assets, nothing is simulated
+    if (source == PathSource::Stored)
+    {
+        PathStore store;
+        if (store.open(store_filename) != PathStoreError::Success)
+            exit(1);
+
+        const PathStoreHeader &store_header = store.header();
+        std::cout << "\nThe path store has " << 2 * store_header.num_pairs << " paths of " << store_header.num_days
+                  << " days (seed " << store_header.seed << ") of the assets:";
+        for (size_t i = 0; i < store_header.num_assets; ++i)
+            std::cout << " " << store.asset(i).name;
+        std::cout << "\n" << std::endl;
+
+        loadBookContracts(store.atTheMoneyStrike(), contracts);
+        double reprice_time = repricePathStore(store, contracts, statistics);
+
+        printBookPrices(contracts, statistics);
+        std::cout << "\nThe book has been repriced on the stored paths in " << reprice_time / 1e6 << " seconds." << std::endl;
+        return;
+    }
+
+      // Vector to store assets
+    std::vector<Asset> assets;
+
+      // Get asset count type from user input
+    AssetCountType asset_count_type = getAssetCountTypeFromUser();
+    if (asset_count_type == AssetCountType::Invalid)
+    {
+        std::cerr << "\nInvalid asset count type" << std::endl;
+        exit(1);
+    }
+
+      // Get the precision of the path kernel from user input
+    PathPrecision precision = getPathPrecisionFromUser();
+    if (precision == PathPrecision::Invalid)
+    {
+        std::cerr << "\nInvalid precision" << std::endl;
+        exit(1);
+    }
+
+      // Load the assets from the CSV files
+    std::cout << "\nLoading assets from csv..." << std::endl;
+
+    LoadAssetError load_result = loadAssets("../data/", assets, asset_count_type);
+    switch (load_result)
+    {
+    case LoadAssetError::Success: 
+        std::cout << "The assets have been loaded successfully.\n"
+                  << std::endl;
+        break;
+    case LoadAssetError::DirectoryOpenError: 
+        exit(1);
+    case LoadAssetError::NoValidFiles: 
+        std::cout << "No valid files found in the directory\n"
+                  << std::endl;
+        exit(1);
+    case LoadAssetError::FileReadError: 
+        exit(1);
+    }
+
+      // Add the new days of the files to the statistics of the assets
+    Matrix covariance_matrix = updateAssetStatistics(assets, asset_count_type);
+
+    loadBookContracts(calculateStrikePrice(assets), contracts);
+
+      // Create a vector of pointers to assets for Monte Carlo computation
+    std::vector<const Asset *> assetPtrs;
+    assetPtrs.reserve(assets.size());
+    for (const auto &asset : assets)
+    {
+        assetPtrs.emplace_back(&asset);
+    }
+
+      // Set the number of iterations and simulations, the daily paths of the
+      // Asian contracts are more expensive than the single step of the European ones
+    bool has_asian = std::any_of(contracts.begin(), contracts.end(),
+                                 [](const OptionContract &contract) { return contract.option_type == OptionType::Asian; });
+    size_t num_iterations  = 10;
+    size_t num_simulations = has_asian ? 1e5 : 1e6;
+    double total_time      = 0.0;
+    MonteCarloError error;
+
+      // Seed of the random streams, every iteration uses the next one
+    std::random_device rd;
+    uint64_t seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+
+      // Simulate all the paths once into the store, then price the book from it
+    if (source == PathSource::SimulateAndStore)
+    {
+        size_t points = num_iterations * num_simulations;
+        PathStoreError store_error;
+
+        std::cout << "Simulating " << points << " paths into " << store_filename << "...\n"
+                  << std::endl;
+        double write_time = writePathStore(store_filename, points, assetPtrs, covariance_matrix, precision, seed, store_error);
+        if (store_error != PathStoreError::Success)
+            exit(1);
+
+        PathStore store;
+        if (store.open(store_filename) != PathStoreError::Success)
+            exit(1);
+        double reprice_time = repricePathStore(store, contracts, statistics);
+
+        printBookPrices(contracts, statistics);
+        std::cout << "\nSeed: " << seed << std::endl;
+        std::cout << "The paths have been simulated and stored in " << write_time / 1e6 << " seconds, the book has been priced on them in "
+                  << reprice_time / 1e6 << " seconds." << std::endl;
+        return;
+    }
+
+    std::cout << "Calculating the prices of the book...\n"
+              << std::endl;
+
+      // Factorize the covariance matrix once for all the iterations
+    CholeskyError cholesky_error;
+    Matrix cholesky_factor = factorizeCovarianceMatrix(covariance_matrix, assets.size(), cholesky_error);
+    if (cholesky_error == CholeskyError::Failure)
+        exit(1);
+
+      // Every iteration evaluates all the contracts on the same paths,
+      // the statistics of every iteration are merged per contract
+    for (size_t j = 0; j < num_iterations; ++j)
+    {
+        total_time += monteCarloBookPricePrediction(num_simulations, assetPtrs, cholesky_factor, contracts, statistics, precision, seed + j, error);
+
+        if (error != MonteCarloError::Success)
+        {
+            std::cerr << "Error in Monte Carlo simulation" << std::endl;
+            exit(1);
+        }
+
+        double progress = static_cast<double>(j + 1) / static_cast<double>(num_iterations) * 100;
+        std::cout << "Process at " << progress << "% ..." << std::endl;
+    }
+
+    printBookPrices(contracts, statistics);
+    std::cout << "\nSeed: " << seed << std::endl;
+    std::cout << "The book has been priced " << num_iterations << " times for " << num_simulations << " points in "
+              << total_time / 1e6 << " seconds." << std::endl;
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+#include "../external/muparser-2.3.4/include/muParser.h"
+#include "../external/muparser-2.3.4/include/muParserIncluder.h"
+
+#include "../include/integration/randomstream.hpp"
+#include "../include/integration/functionevaluator.hpp"
+#include "test.hpp"
+
+  // Points of the comparison, in blocks of BLOCK_SIZE with a shorter last block, in
+  // [-2, 2]^3 so the square roots and logarithms of negative values give NaN
+constexpr size_t DIMENSION  = 3;
+constexpr size_t BLOCK_SIZE = 256;
+constexpr size_t NUM_POINTS = 4000;
+constexpr double LOWER      = -2.0;
+constexpr double UPPER      = 2.0;
+
+  // Largest relative error accepted against muParser: the vectorized exp, log, sin and
+  // cos kernels round differently from the standard library by a few ulps
+constexpr double TOLERANCE = 1e-14;
+
+  // Expressions of the comparison: operator precedence, unary minus, the functions
+  // lowered to kernels or called through muParser, the ternary operator and NaN
+static const std::vector<std::string> EXPRESSIONS = {
+      // Precedence and associativity
+    "x1 + x2 * x3",
+    "(x1 + x2) * x3",
+    "x1 - x2 - x3",
+    "x1 / x2 / x3",
+    "x1 * x2 + x3 * x1 - x2",
+    "x1 + x2 / x3 * x1",
+    "2^3^2 * x1",
+    "x1^2 + x2^2 + x3^2",
+    "x1^3 - x2^4",
+    "(x1 * x2)^2 / (1 + x3^2)",
+    "1 + 2 * 3 - 4 / 8 + x1",
+      // Unary minus
+    "-x1",
+    "-x1^2",
+    "-(x1 + x2) * -x3",
+    "x1 * -x2",
+    "-(-x1) + -(-x2 * x3)",
+    "-2^2 + x1",
+    "x1 - -x2",
+      // Functions
+    "sin(x1) + cos(x2)",
+    "exp(x1) * exp(-x2)",
+    "exp(x1 * x2 * x3)",
+    "log(abs(x1) + 1)",
+    "sqrt(x1^2 + x2^2 + x3^2)",
+    "abs(x1 - x2)",
+    "min(x1, x2) + max(x2, x3)",
+    "tan(x1 / 4)",
+    "atan(x1) + tanh(x2)",
+    "log10(abs(x3) + 0.5) + log2(abs(x1) + 0.5)",
+    "sign(x1) * rint(x2 * 3)",
+    "sin(x1)^2 + cos(x1)^2",
+    "exp(-(x1^2 + x2^2) / 2)",
+    "cos(x1 * x2) * sin(x3) / (1 + x1^2)",
+    "_pi * x1 + _e * x2",
+      // Comparisons, logic and the ternary operator
+    "x1 < x2 ? x1 : x2",
+    "x1^2 + x2^2 <= 1 ? 1 : 0",
+    "x1 > 0 && x2 > 0 ? x1 * x2 : -x3",
+    "x1 > 1 || x2 < -1 ? exp(x3) : log(abs(x3) + 1)",
+    "x1 == x1 ? x2 : x3",
+    "x1 != x2 ? (x3 >= 0 ? x3 : -x3) : 0",
+    "x1 > 0 ? x2 > 0 ? 1 : 2 : 3",
+    "(x1 < 0) + (x2 < 0) + (x3 < 0)",
+      // NaN propagation
+    "sqrt(x1)",
+    "log(x2)",
+    "sqrt(x1) + x2 * 0",
+    "log(x1) * 0 + 1",
+    "x1 > 0 ? sqrt(x1) : sqrt(x2)",
+    "min(sqrt(x1), x2)",
+};
+
+  // Both values are NaN, or their relative error is within the tolerance
+static bool sameValue(double value, double reference, double &error)
+{
+    if (std::isnan(value) || std::isnan(reference))
+    {
+        error = 0.0;
+        return std::isnan(value) && std::isnan(reference);
+    }
+    if (value == reference)
+    {
+        error = 0.0;
+        return true;
+    }
+    error = std::fabs(value - reference) / std::max(std::fabs(reference), 1.0);
+    return error <= TOLERANCE;
+}
+
+  // Differential test of CompiledExpression: every expression is evaluated on the same
+  // points by the block program of BulkFunctionEvaluator and by the muParser interpreter
+int main()
+{
+    RandomStream stream(2024, 0);
+    std::vector<double> points(DIMENSION * NUM_POINTS);
+    stream.fillUniform(points.data(), points.size(), LOWER, UPPER);
+
+    double largest_error = 0.0;
+    for (const std::string &expression : EXPRESSIONS)
+    {
+        BulkFunctionEvaluator compiled(expression, DIMENSION, BLOCK_SIZE);
+        FunctionEvaluator reference(expression, DIMENSION);
+        if (!compiled.isCompiled())
+        {
+            check(expression, false, "not lowered");
+            continue;
+        }
+
+        std::vector<double> &block = compiled.getBlock();
+        std::vector<double> results(BLOCK_SIZE);
+        size_t mismatches = 0;
+        double error      = 0.0;
+        for (size_t first = 0; first < NUM_POINTS; first += BLOCK_SIZE)
+        {
+            size_t count = std::min(BLOCK_SIZE, NUM_POINTS - first);
+            for (size_t j = 0; j < DIMENSION; ++j)
+            {
+                for (size_t k = 0; k < count; ++k)
+                    block[j * BLOCK_SIZE + k] = points[(first + k) * DIMENSION + j];
+            }
+            compiled.evaluate(results, count);
+
+            for (size_t k = 0; k < count; ++k)
+            {
+                std::copy(&points[(first + k) * DIMENSION], &points[(first + k + 1) * DIMENSION], reference.getPoint().begin());
+                double point_error = 0.0;
+                mismatches += !sameValue(results[k], reference.evaluate(), point_error);
+                error       = std::max(error, point_error);
+            }
+        }
+
+        largest_error = std::max(largest_error, error);
+        std::ostringstream detail;
+        detail << mismatches << " mismatches, largest relative error " << error;
+        check(expression, mismatches == 0, detail.str());
+    }
+
+    std::cout << EXPRESSIONS.size() << " expressions, largest relative error " << largest_error << " (tolerance " << TOLERANCE << ")" << std::endl;
+    return testResult();
+}
@@ -0,0 +1,66 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+
+#include "../external/muparser-2.3.4/include/muParser.h"
+#include "../external/muparser-2.3.4/include/muParserIncluder.h"
+
+#include "../include/integration/randomstream.hpp"
+#include "../include/integration/geometry/hypersphere.hpp"
+#include "test.hpp"
+
+  // Direct sampler in d = 10: ten normals and one radial uniform per point, the
+  // normals of a column of odd length take one more uniform
+constexpr size_t DIMENSION  = 10;
+constexpr size_t BLOCK_SIZE = 256;
+constexpr size_t NUM_BLOCKS = 8;
+constexpr size_t ODD_COUNT  = 101;
+
+  // Uniforms per point of the direct sampler on blocks of count points
+static double directUniformsPerPoint(size_t count, bool single_precision)
+{
+    HyperSphere sphere(DIMENSION, 1.0, SphereSampler::Direct);
+    RandomStream stream(2024, 0, single_precision);
+    std::vector<double> block(DIMENSION * BLOCK_SIZE), scratch;
+    for (size_t b = 0; b < NUM_BLOCKS; ++b)
+        sphere.generateRandomBlock(block, BLOCK_SIZE, count, stream, scratch);
+    return sphere.getUniformsPerPoint();
+}
+
+  // Uniforms per point of the rejection sampler, one point at a time
+static double rejectionUniformsPerPoint(bool single_precision)
+{
+    HyperSphere sphere(2, 1.0, SphereSampler::Rejection);
+    RandomStream stream(2024, 0, single_precision);
+    std::vector<double> point(2);
+    for (size_t k = 0; k < BLOCK_SIZE; ++k)
+        sphere.generateRandomPoint(point, stream);
+    return sphere.getUniformsPerPoint();
+}
+
+  // Tests of the uniforms counted by HyperSphere: the count is the number of uniforms
+  // returned by the stream, the same in double and in single precision
+int main()
+{
+    for (bool single_precision : {false, true})
+    {
+        std::string precision = single_precision ? "single" : "double";
+
+        double even = directUniformsPerPoint(BLOCK_SIZE, single_precision);
+        checkTolerance("direct sampler, " + precision + " precision", "uniforms per point " + std::to_string(even) + ", error",
+                       std::fabs(even - (DIMENSION + 1)), 0.0);
+
+        double odd      = directUniformsPerPoint(ODD_COUNT, single_precision);
+        double expected = DIMENSION + 1 + static_cast<double>(DIMENSION) / ODD_COUNT;
+        checkTolerance("direct sampler on odd blocks, " + precision + " precision", "uniforms per point " + std::to_string(odd) + ", error",
+                       std::fabs(odd - expected), 1e-12);
+
+          // Two uniforms per candidate, 4 / pi candidates per accepted point on average
+        double rejection = rejectionUniformsPerPoint(single_precision);
+        checkTolerance("rejection sampler, " + precision + " precision", "uniforms per point " + std::to_string(rejection) + ", relative error",
+                       std::fabs(rejection / (8.0 / PI) - 1.0), 0.1);
+    }
+
+    return testResult();
+}
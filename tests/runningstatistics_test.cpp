@@ -0,0 +1,110 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+
+#include "../include/integration/randomstream.hpp"
+#include "../include/integration/runningstatistics.hpp"
+#include "test.hpp"
+
+  // Number of samples of U(1e4, 1e4 + 1): the variance 1/12 is 1e-9 times the mean
+  // squared, so E[x^2] - E[x]^2 would keep less than 8 significant digits
+constexpr size_t NUM_SAMPLES = size_t(1) << 22;
+constexpr double LOWER       = 1e4;
+constexpr double UPPER       = 1e4 + 1.0;
+
+  // Largest relative errors accepted against the long double reference: the compensated
+  // updates keep the variance to a few ulps, the blocks round their two-pass sums once
+constexpr double MEAN_TOLERANCE           = 1e-15;
+constexpr double VARIANCE_TOLERANCE       = 1e-15;
+constexpr double BLOCK_VARIANCE_TOLERANCE = 1e-13;
+
+  // Reference mean and variance of the samples, two passes in long double
+template <typename T>
+static void referenceMoments(const std::vector<T> &x, long double &mean, long double &variance)
+{
+    long double sum = 0.0L;
+    for (T value : x)
+        sum += static_cast<long double>(value);
+    mean = sum / static_cast<long double>(x.size());
+
+    long double squares = 0.0L;
+    for (T value : x)
+        squares += (static_cast<long double>(value) - mean) * (static_cast<long double>(value) - mean);
+    variance = squares / static_cast<long double>(x.size());
+}
+
+static double relativeError(double value, long double reference)
+{
+    return static_cast<double>(std::fabs((static_cast<long double>(value) - reference) / reference));
+}
+
+static void checkStatistics(const std::string &name, const RunningStatistics &statistics, size_t count, long double mean, long double variance, double variance_tolerance)
+{
+    if (statistics.getCount() != count)
+        check(name, false, std::to_string(statistics.getCount()) + " samples instead of " + std::to_string(count));
+    checkTolerance(name + " mean", "relative error", relativeError(statistics.getMean(), mean), MEAN_TOLERANCE);
+    checkTolerance(name + " variance", "relative error", relativeError(statistics.getVariance(), variance), variance_tolerance);
+}
+
+  // Tests of RunningStatistics and pairwiseSum against a long double reference, on the
+  // ill-conditioned samples of U(1e4, 1e4 + 1)
+int main()
+{
+    RandomStream stream(2024, 0);
+    std::vector<double> samples(NUM_SAMPLES);
+    stream.fillUniform(samples.data(), samples.size(), LOWER, UPPER);
+
+    long double mean, variance;
+    referenceMoments(samples, mean, variance);
+
+      // Welford updates, one sample at a time
+    RunningStatistics added;
+    for (double x : samples)
+        added.add(x);
+    checkStatistics("add", added, NUM_SAMPLES, mean, variance, VARIANCE_TOLERANCE);
+
+      // Chunks of uneven sizes accumulated separately and merged in order, with
+      // empty statistics merged on both sides
+    RunningStatistics merged;
+    merged.merge(RunningStatistics());
+    for (size_t first = 0, chunk = 1; first < NUM_SAMPLES; first += chunk, chunk = chunk % 4093 + 1)
+    {
+        RunningStatistics part;
+        for (size_t k = first; k < std::min(NUM_SAMPLES, first + chunk); ++k)
+            part.add(samples[k]);
+        part.merge(RunningStatistics());
+        merged.merge(part);
+    }
+    checkStatistics("merge", merged, NUM_SAMPLES, mean, variance, VARIANCE_TOLERANCE);
+
+      // Blocks with two passes, the last one shorter
+    RunningStatistics blocks;
+    for (size_t first = 0; first < NUM_SAMPLES; first += 1000)
+        blocks.addBlock(samples.data() + first, std::min<size_t>(1000, NUM_SAMPLES - first));
+    checkStatistics("addBlock double", blocks, NUM_SAMPLES, mean, variance, BLOCK_VARIANCE_TOLERANCE);
+
+      // Single precision samples are accumulated in double, the reference is taken
+      // on the same float values
+    std::vector<float> single_samples(samples.begin(), samples.end());
+    long double single_mean, single_variance;
+    referenceMoments(single_samples, single_mean, single_variance);
+
+    RunningStatistics single_blocks;
+    for (size_t first = 0; first < NUM_SAMPLES; first += 1000)
+        single_blocks.addBlock(single_samples.data() + first, std::min<size_t>(1000, NUM_SAMPLES - first));
+    checkStatistics("addBlock float", single_blocks, NUM_SAMPLES, single_mean, single_variance, BLOCK_VARIANCE_TOLERANCE);
+
+      // Pairwise sums around the base case and on the whole array
+    for (size_t n : {size_t(1), PAIRWISE_BASE - 1, PAIRWISE_BASE, PAIRWISE_BASE + 1, size_t(100003), NUM_SAMPLES})
+    {
+        long double sum = 0.0L;
+        for (size_t k = 0; k < n; ++k)
+            sum += static_cast<long double>(samples[k]);
+        checkTolerance("pairwiseSum n = " + std::to_string(n), "relative error", relativeError(pairwiseSum(samples.data(), n), sum), MEAN_TOLERANCE);
+    }
+    double empty_sum = pairwiseSum(samples.data(), 0);
+    check("pairwiseSum n = 0", empty_sum == 0.0, "sum " + std::to_string(empty_sum));
+
+    return testResult();
+}
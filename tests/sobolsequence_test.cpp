@@ -0,0 +1,75 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+#include "../include/integration/qmcsequence.hpp"
+#include "test.hpp"
+
+  // Points of the blocks that end on the last index of a replicate, in the first
+  // dimensions and in the last dimension of the direction number table
+constexpr size_t BOUNDARY_COUNT = 1500;
+constexpr size_t DIMENSION      = SobolSequence::MAX_DIMENSION;
+
+  // Points of the stratification check, one per cell of a 32 x 32 grid
+constexpr size_t STRATIFIED_COUNT = 1024;
+constexpr size_t GRID             = 32;
+
+  // Tests of SobolSequence::generateBlock: the blocks ending on the index 2^32 - 1 match the
+  // points generated one by one with the skip-ahead, and the first points are stratified
+int main()
+{
+    SobolSequence sequence(DIMENSION, 2024, 3);
+
+      // Blocks of uneven sizes up to the last point of the replicate, against single points
+    uint64_t first = SobolSequence::MAX_POINTS - BOUNDARY_COUNT;
+    std::vector<double> block(DIMENSION * BOUNDARY_COUNT);
+    sequence.generateBlock(block, BOUNDARY_COUNT, first, BOUNDARY_COUNT);
+
+    std::vector<double> part(DIMENSION * BOUNDARY_COUNT);
+    size_t mismatches = 0, out_of_range = 0;
+    for (size_t offset = 0, count = 1; offset < BOUNDARY_COUNT; offset += count, count = count % 97 + 1)
+    {
+        count = std::min(count, BOUNDARY_COUNT - offset);
+        sequence.generateBlock(part, BOUNDARY_COUNT, first + offset, count);
+        for (size_t j = 0; j < DIMENSION; ++j)
+        {
+            for (size_t k = 0; k < count; ++k)
+            {
+                double value = part[j * BOUNDARY_COUNT + k];
+                mismatches   += value != block[j * BOUNDARY_COUNT + offset + k];
+                out_of_range += !(value > 0.0 && value < 1.0);
+            }
+        }
+    }
+    check("blocks up to 2^32 - 1", mismatches == 0, std::to_string(mismatches) + " points differ from the whole block");
+    check("range up to 2^32 - 1", out_of_range == 0, std::to_string(out_of_range) + " coordinates outside (0, 1)");
+
+    std::vector<double> last(DIMENSION);
+    sequence.generateBlock(last, 1, SobolSequence::MAX_POINTS - 1, 1);
+    size_t last_mismatches = 0;
+    for (size_t j = 0; j < DIMENSION; ++j)
+        last_mismatches += last[j] != block[j * BOUNDARY_COUNT + BOUNDARY_COUNT - 1];
+    check("point 2^32 - 1", last_mismatches == 0, std::to_string(last_mismatches) + " coordinates differ from the skip-ahead");
+
+      // The scrambling keeps the (0, m, 2)-net property of the first two dimensions:
+      // the first 2^10 points fill every cell of the 32 x 32 grid once
+    std::vector<double> net(2 * STRATIFIED_COUNT);
+    SobolSequence plane(2, 2024, 3);
+    plane.generateBlock(net, STRATIFIED_COUNT, 0, STRATIFIED_COUNT);
+
+    std::vector<size_t> cells(GRID * GRID, 0);
+    for (size_t k = 0; k < STRATIFIED_COUNT; ++k)
+    {
+        size_t x = static_cast<size_t>(net[k] * GRID);
+        size_t y = static_cast<size_t>(net[STRATIFIED_COUNT + k] * GRID);
+        ++cells[y * GRID + x];
+    }
+    size_t empty_cells = 0;
+    for (size_t cell : cells)
+        empty_cells += cell != 1;
+    check("stratification", empty_cells == 0, std::to_string(empty_cells) + " cells without exactly one point");
+
+    return testResult();
+}
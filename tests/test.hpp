@@ -0,0 +1,58 @@
+/**
+ * @file test.hpp
+ * @brief This file contains the checks and the report shared by the tests.
+ */
+
+#ifndef PROJECT_TEST_HPP
+    #define PROJECT_TEST_HPP
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+  /**
+ * @brief The number of failed checks of the test
+ */
+inline int test_failures = 0;
+
+  /**
+ * @brief Print the outcome of a check and count it if it failed.
+ * @param name The name of the check.
+ * @param passed True if the check passed.
+ * @param detail The measured value of the check, printed after the name.
+ * @return passed.
+ */
+inline bool check(const std::string &name, bool passed, const std::string &detail)
+{
+    std::cout << (passed ? "[PASS] " : "[FAIL] ") << name << ": " << detail << std::endl;
+    if (!passed)
+        ++test_failures;
+    return passed;
+}
+
+  /**
+ * @brief Check that an error is within a tolerance.
+ * @param name The name of the check.
+ * @param quantity The name of the error, e.g. "relative error".
+ * @param error The measured error.
+ * @param tolerance The largest error accepted.
+ * @return True if the check passed.
+ */
+inline bool checkTolerance(const std::string &name, const std::string &quantity, double error, double tolerance)
+{
+    std::ostringstream detail;
+    detail << quantity << " " << error << " (tolerance " << tolerance << ")";
+    return check(name, error <= tolerance, detail.str());
+}
+
+  /**
+ * @brief Print the summary of the test.
+ * @return The exit code of the test, 0 if every check passed.
+ */
+inline int testResult()
+{
+    std::cout << (test_failures == 0 ? "All tests passed" : std::to_string(test_failures) + " tests failed") << std::endl;
+    return test_failures == 0 ? 0 : 1;
+}
+
+#endif